@@ -2,11 +2,13 @@
 #include <vector>
 
 // 定义矩阵乘法函数
-std::vector<std::vector<long long>> matrixMultiply(const std::vector<std::vector<long long>>& a, const std::vector<std::vector<long long>>& b) {
+// 元素类型 T 只需要 T(0)、+= 和 *，例如 long long 或 mod_int<M>（ch13_mod_int.h）
+template <typename T>
+std::vector<std::vector<T>> matrixMultiply(const std::vector<std::vector<T>>& a, const std::vector<std::vector<T>>& b) {
     int rowsA = a.size();
     int colsA = a[0].size();
     int colsB = b[0].size();
-    std::vector<std::vector<long long>> result(rowsA, std::vector<long long>(colsB, 0));
+    std::vector<std::vector<T>> result(rowsA, std::vector<T>(colsB, T(0)));
 
     for (int i = 0; i < rowsA; ++i) {
         for (int j = 0; j < colsB; ++j) {
@@ -19,14 +21,15 @@ std::vector<std::vector<long long>> matrixMultiply(const std::vector<std::vector
 }
 
 // 定义矩阵快速幂函数
-std::vector<std::vector<long long>> matrixPower(const std::vector<std::vector<long long>>& matrix, int n) {
+template <typename T>
+std::vector<std::vector<T>> matrixPower(const std::vector<std::vector<T>>& matrix, int n) {
     int size = matrix.size();
-    std::vector<std::vector<long long>> result(size, std::vector<long long>(size, 0));
+    std::vector<std::vector<T>> result(size, std::vector<T>(size, T(0)));
     // 初始化结果矩阵为单位矩阵
     for (int i = 0; i < size; ++i) {
-        result[i][i] = 1;
+        result[i][i] = T(1);
     }
-    std::vector<std::vector<long long>> base = matrix;
+    std::vector<std::vector<T>> base = matrix;
 
     while (n > 0) {
         if (n % 2 == 1) {
@@ -0,0 +1,40 @@
+// -------------------------------------------------------------------
+// ch03_bitmap.cpp -- For testing ch03_bitmap.h.
+// -------------------------------------------------------------------
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch03_bitmap.h"
+
+int main() {
+  typedef long long N;
+
+  // 代理迭代器上的 sift 与 std::vector<char> 上的结果逐位对照
+  packed_sieve p(500);
+  sift(p.begin(), N(500));
+  std::cout << "sift(p.begin(), 500) with packed_sieve p(500):\n2";
+  for (std::size_t i = p.find_next(0); i < p.size(); i = p.find_next(i + 1)) {
+    std::cout << " " << 2 * i + 3;
+  }
+  std::cout << std::endl;
+  std::cout << "p.count() = " << p.count() << std::endl;
+  std::cout << "p.find_next(100) = " << p.find_next(100) << std::endl;
+
+  N n = 50000000;
+  packed_sieve q(n);
+  sift(q.begin(), n);
+  std::vector<char> v(n);
+  sift(v.begin(), n);
+  bool same = true;
+  for (N i = 0; i < n; ++i) {
+    if (q[i] != bool(v[i])) same = false;
+  }
+  std::cout << "odd primes below 10^8: q.count() = " << q.count()
+            << ", same as sift on std::vector<char>: " << same
+            << ", count(10^6, 2 * 10^6) = " << q.count(1000000, 2000000)
+            << " (expected "
+            << std::count(v.begin() + 1000000, v.begin() + 2000000, char(1))
+            << ")" << std::endl;
+}
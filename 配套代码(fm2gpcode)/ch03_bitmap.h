@@ -0,0 +1,194 @@
+// -------------------------------------------------------------------
+// ch03_bitmap.h -- Bit-packed odd-only storage for sift
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// packed_sieve 用一个比特表示一个奇数候选（下标 i 对应 2i + 3），
+// 按 64 位字存放，比 std::vector<int> 节省 32 倍内存。
+// bit_iterator 是随机访问的代理迭代器，sift、mark_sieve 和
+// print_sieve 无需任何修改即可使用；整字操作的快速路径（fill、count、
+// find_next）则以成员函数的形式提供。
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+typedef std::uint64_t sieve_word;
+
+const std::ptrdiff_t sieve_word_bits = 64;
+
+// 以下三个函数直接作用于 64 位字数组，packed_sieve 和内存映射的
+// 素数表（ch03_table.h）共用它们。
+
+// words 中下标 [first, last) 内置位比特的个数
+inline std::size_t count_bits(const sieve_word* words,
+                              std::size_t first, std::size_t last) {
+    if (first >= last) return 0;
+    std::size_t f = first / sieve_word_bits;
+    std::size_t l = (last - 1) / sieve_word_bits;
+    sieve_word head = ~sieve_word(0) << (first % sieve_word_bits);
+    sieve_word tail = ~sieve_word(0) >> (sieve_word_bits - 1
+                                         - (last - 1) % sieve_word_bits);
+    if (f == l) return std::popcount(words[f] & head & tail);
+    std::size_t c = std::popcount(words[f] & head);
+    for (std::size_t k = f + 1; k < l; ++k) c += std::popcount(words[k]);
+    return c + std::popcount(words[l] & tail);
+}
+
+// words 的前 n 个比特中，不小于 i 的第一个置位下标；不存在时返回 n
+inline std::size_t find_next_bit(const sieve_word* words,
+                                 std::size_t n, std::size_t i) {
+    if (i >= n) return n;
+    std::size_t k = i / sieve_word_bits;
+    std::size_t size = (n + sieve_word_bits - 1) / sieve_word_bits;
+    sieve_word w = words[k] & (~sieve_word(0) << (i % sieve_word_bits));
+    while (w == 0) {
+        if (++k == size) return n;
+        w = words[k];
+    }
+    return std::min(n, k * sieve_word_bits + std::countr_zero(w));
+}
+
+// 把每个元素表示一个候选的区间 [first, last) 压缩成比特写入 out
+template <typename I>
+sieve_word* pack_bits(I first, I last, sieve_word* out) {
+    while (first != last) {
+        std::ptrdiff_t k = std::min(sieve_word_bits,
+                                    std::ptrdiff_t(last - first));
+        sieve_word x = 0;
+        for (std::ptrdiff_t i = 0; i < k; ++i) {
+            x |= sieve_word(bool(first[i])) << i;
+        }
+        *out++ = x;
+        first += k;
+    }
+    return out;
+}
+
+class bit_reference {
+    sieve_word* word;
+    sieve_word mask;
+public:
+    bit_reference(sieve_word* word, sieve_word mask)
+        : word(word), mask(mask) {}
+
+    operator bool() const { return (*word & mask) != 0; }
+
+    bit_reference& operator=(bool x) {
+        if (x) *word |= mask;
+        else   *word &= ~mask;
+        return *this;
+    }
+
+    bit_reference& operator=(const bit_reference& x) {
+        return *this = bool(x);
+    }
+};
+
+class bit_iterator {
+    sieve_word* words;
+    std::ptrdiff_t i;
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef bool value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef void pointer;
+    typedef bit_reference reference;
+
+    bit_iterator() : words(nullptr), i(0) {}
+    bit_iterator(sieve_word* words, std::ptrdiff_t i) : words(words), i(i) {}
+
+    sieve_word* base() const { return words; }
+    std::ptrdiff_t index() const { return i; }
+
+    reference operator*() const {
+        return reference(words + i / sieve_word_bits,
+                         sieve_word(1) << (i % sieve_word_bits));
+    }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bit_iterator& operator++() { ++i; return *this; }
+    bit_iterator& operator--() { --i; return *this; }
+    bit_iterator operator++(int) { bit_iterator tmp(*this); ++i; return tmp; }
+    bit_iterator operator--(int) { bit_iterator tmp(*this); --i; return tmp; }
+    bit_iterator& operator+=(difference_type n) { i += n; return *this; }
+    bit_iterator& operator-=(difference_type n) { i -= n; return *this; }
+
+    friend bit_iterator operator+(bit_iterator x, difference_type n) {
+        return x += n;
+    }
+    friend bit_iterator operator+(difference_type n, bit_iterator x) {
+        return x += n;
+    }
+    friend bit_iterator operator-(bit_iterator x, difference_type n) {
+        return x -= n;
+    }
+    friend difference_type operator-(const bit_iterator& x,
+                                     const bit_iterator& y) {
+        return x.i - y.i;
+    }
+
+    friend bool operator==(const bit_iterator& x, const bit_iterator& y) {
+        return x.i == y.i;
+    }
+    friend bool operator!=(const bit_iterator& x, const bit_iterator& y) {
+        return !(x == y);
+    }
+    friend bool operator<(const bit_iterator& x, const bit_iterator& y) {
+        return x.i < y.i;
+    }
+    friend bool operator>(const bit_iterator& x, const bit_iterator& y) {
+        return y < x;
+    }
+    friend bool operator<=(const bit_iterator& x, const bit_iterator& y) {
+        return !(y < x);
+    }
+    friend bool operator>=(const bit_iterator& x, const bit_iterator& y) {
+        return !(x < y);
+    }
+};
+
+class packed_sieve {
+    std::vector<sieve_word> words;
+    std::size_t n;
+
+    // 最后一个字中超出 n 的比特必须保持为 0，count 才能直接用 popcount
+    void clear_padding() {
+        std::size_t r = n % sieve_word_bits;
+        if (r != 0) words.back() &= (sieve_word(1) << r) - 1;
+    }
+
+public:
+    explicit packed_sieve(std::size_t n)
+        : words((n + sieve_word_bits - 1) / sieve_word_bits), n(n) {}
+
+    std::size_t size() const { return n; }
+    sieve_word* data() { return words.data(); }
+    const sieve_word* data() const { return words.data(); }
+
+    bit_iterator begin() { return bit_iterator(words.data(), 0); }
+    bit_iterator end() { return bit_iterator(words.data(), n); }
+
+    bool operator[](std::size_t i) const {
+        return (words[i / sieve_word_bits] >> (i % sieve_word_bits)) & 1;
+    }
+
+    void fill(bool x) {
+        std::fill(words.begin(), words.end(), x ? ~sieve_word(0) : 0);
+        clear_padding();
+    }
+
+    // [first, last) 中素数（置位比特）的个数
+    std::size_t count(std::size_t first, std::size_t last) const {
+        return count_bits(words.data(), first, last);
+    }
+
+    std::size_t count() const { return count(0, n); }
+
+    // 不小于 i 的第一个置位下标；若不存在则返回 size()
+    std::size_t find_next(std::size_t i) const {
+        return find_next_bit(words.data(), n, i);
+    }
+};
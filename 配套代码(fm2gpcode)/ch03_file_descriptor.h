@@ -0,0 +1,25 @@
+// -------------------------------------------------------------------
+// ch03_file_descriptor.h -- Scoped POSIX file descriptor
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// open、mkstemp 之后的读写都可能抛出异常；file_descriptor 在离开作用域
+// 时关闭描述符，任何路径上都不会泄漏。mmap 建立的映射不依赖描述符，
+// 映射之后关闭是安全的。
+
+#include <unistd.h>
+
+class file_descriptor {
+    int fd;
+
+public:
+    explicit file_descriptor(int fd) : fd(fd) {}
+
+    ~file_descriptor() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    int get() const { return fd; }
+};
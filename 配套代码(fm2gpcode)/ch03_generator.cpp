@@ -0,0 +1,38 @@
+// -------------------------------------------------------------------
+// ch03_generator.cpp -- For testing ch03_generator.h.
+// -------------------------------------------------------------------
+
+#include <iostream>
+#include "ch03.h"
+#include "ch03_segmented.h"
+#include "ch03_generator.h"
+
+int main() {
+  typedef long long N;
+
+  std::cout << "first 20 primes:";
+  int k = 0;
+  for (N p : prime_generator<N>()) {
+    if (k++ == 20) break;
+    std::cout << " " << p;
+  }
+  std::cout << std::endl;
+
+  // 第 10^7 个素数
+  prime_generator<N> g;
+  for (N count = 1; count < 10000000; ++count) ++g;
+  std::cout << "10^7-th prime = " << *g << std::endl;
+
+  std::cout << "next_prime(1) = " << next_prime(N(1)) << std::endl;
+  std::cout << "next_prime(2) = " << next_prime(N(2)) << std::endl;
+  std::cout << "next_prime(100) = " << next_prime(N(100)) << std::endl;
+  std::cout << "next_prime(10^12) = " << next_prime(N(1000000000000))
+            << std::endl;
+
+  std::cout << "primes in [10^9, 10^9 + 100):";
+  for (N p : prime_generator<N>(1000000000)) {
+    if (p >= 1000000100) break;
+    std::cout << " " << p;
+  }
+  std::cout << std::endl;
+}
@@ -0,0 +1,129 @@
+// -------------------------------------------------------------------
+// ch03_generator.h -- Lazy, unbounded prime generator
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// prime_generator 不需要预先知道上界：只有当使用者走到当前窗口末尾
+// 时，才筛下一个窗口。窗口大小固定，筛用素数只增长到当前位置的
+// 平方根，因此内存有界。它提供输入迭代器和哨兵，可以直接用于
+// 范围 for 循环，在满足条件时 break 即可：
+//
+//     for (long long p : prime_generator<long long>(x)) { ... }
+//
+// 使用前需先包含 ch03.h 和 ch03_segmented.h。
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#define Integer typename
+
+template <Integer N>
+class prime_generator {
+    std::vector<char> window;
+    std::vector<N> factors;  // 所有满足 p * p <= factor_limit 的奇素数
+    std::vector<N> next;     // 每个因子下一个待划掉的下标
+    N factor_limit;
+    N lo;                    // window[0] 对应的下标
+    N i;                     // 当前素数在窗口中的位置
+    N current;
+    bool at_two;
+
+    void extend_factors(N m) {
+        factor_limit = std::max(m, factor_limit + factor_limit);
+        std::vector<N> f = sieving_primes(factor_limit);
+        for (std::size_t j = factors.size(); j < f.size(); ++j) {
+            next.push_back(sieve_start_index(f[j], lo));
+        }
+        factors.swap(f);
+    }
+
+    void sieve_window() {
+        N n = N(window.size());
+        N end = lo + n;
+        if (sieve_index_to_number(end - N(1)) > factor_limit) {
+            extend_factors(sieve_index_to_number(end - N(1)));
+        }
+        presieve(window.begin(), n, lo);
+        for (std::size_t j = 0; j < factors.size(); ++j) {
+            N p = factors[j];
+            if (p <= N(presieve_largest_prime)) continue;
+            if (next[j] < end) {
+                mark_sieve(window.begin() + (next[j] - lo), window.end(), p);
+                next[j] += (end - next[j] + p - N(1)) / p * p;
+            }
+        }
+    }
+
+    void find_prime() {
+        // 从窗口位置 i 开始找下一个素数，必要时筛新的窗口
+        while (true) {
+            auto p = std::find(window.begin() + i, window.end(), char(1));
+            if (p != window.end()) {
+                i = N(p - window.begin());
+                current = sieve_index_to_number(lo + i);
+                return;
+            }
+            lo += N(window.size());
+            i = N(0);
+            sieve_window();
+        }
+    }
+
+public:
+    explicit prime_generator(N start = N(2),
+                             N window_size = N(sieve_window_size))
+        : window(window_size), factor_limit(0), lo(0), i(0), current(2),
+          at_two(start <= N(2)) {
+        // 第一个产生的素数是不小于 start 的最小素数
+        if (start > N(3)) {
+            N index = number_to_sieve_index(start - N(1) - (start % N(2)))
+                      + N(1);
+            lo = index / window_size * window_size;
+            i = index - lo;
+        }
+        sieve_window();
+        if (!at_two) find_prime();
+    }
+
+    N operator*() const { return current; }
+
+    prime_generator& operator++() {
+        if (at_two) {
+            at_two = false;
+        } else {
+            ++i;
+        }
+        find_prime();
+        return *this;
+    }
+
+    class iterator {
+        prime_generator* g;
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef N value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const N* pointer;
+        typedef N reference;
+
+        iterator() : g(nullptr) {}
+        explicit iterator(prime_generator& g) : g(&g) {}
+        N operator*() const { return **g; }
+        iterator& operator++() { ++*g; return *this; }
+        void operator++(int) { ++*g; }
+
+        // 素数是无穷的，迭代器永远到不了哨兵
+        friend bool operator==(const iterator&, std::default_sentinel_t) {
+            return false;
+        }
+    };
+
+    iterator begin() { return iterator(*this); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+};
+
+template <Integer N>
+N next_prime(N x) {
+    // 大于 x 的最小素数
+    return *prime_generator<N>(x + N(1), N(1024));
+}
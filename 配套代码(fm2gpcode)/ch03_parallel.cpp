@@ -0,0 +1,28 @@
+// -------------------------------------------------------------------
+// ch03_parallel.cpp -- For testing ch03_parallel.h.
+// -------------------------------------------------------------------
+
+#include <iostream>
+#include "ch03.h"
+#include "ch03_bitmap.h"
+#include "ch03_segmented.h"
+#include "ch03_parallel.h"
+
+int main() {
+  typedef long long N;
+  N n = 5000000;
+  packed_sieve expected(n);
+  sift(expected.begin(), n);
+
+  for (unsigned threads : {1u, 2u, 3u, 4u, 7u}) {
+    packed_sieve s(n);
+    sift_parallel(s, threads);
+    bool same = std::equal(s.data(), s.data() + (n + 63) / 64,
+                           expected.data());
+    std::cout << "threads = " << threads
+              << ": count_primes_parallel = " << count_primes_parallel(n, threads)
+              << ", sift_parallel count = " << s.count()
+              << ", same bitmap as sift: " << same << std::endl;
+  }
+  std::cout << "sift count = " << expected.count() << std::endl;
+}
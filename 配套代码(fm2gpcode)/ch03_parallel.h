@@ -0,0 +1,84 @@
+// -------------------------------------------------------------------
+// ch03_parallel.h -- Multithreaded segmented sieve
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// 把奇数下标空间 [0, n) 按 64 对齐切成若干段，每个线程用自己的窗口
+// 和自己的偏移表（sift_segmented 内部的 next 数组）筛自己的段。
+// 各段边界都落在 64 位字的边界上，因此线程写共享的 packed_sieve 时
+// 不会碰到同一个字，计数结果也各写各的槽位，全程无需加锁。
+// 使用前需先包含 ch03.h、ch03_bitmap.h 和 ch03_segmented.h。
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#define Integer typename
+
+template <Integer N>
+std::vector<N> split_sieve_range(N n, unsigned parts) {
+    // 返回 parts + 1 个边界，除最后一个外都是 64 的倍数
+    std::vector<N> bounds(parts + 1);
+    N step = (n / N(parts) + N(63)) / N(64) * N(64);
+    for (unsigned t = 0; t < parts; ++t) {
+        bounds[t] = std::min(N(t) * step, n);
+    }
+    bounds[parts] = n;
+    return bounds;
+}
+
+inline unsigned default_sieve_threads() {
+    unsigned t = std::thread::hardware_concurrency();
+    return t == 0 ? 1 : t;
+}
+
+template <Integer N>
+N count_primes_parallel(N n, unsigned threads = default_sieve_threads()) {
+    // 返回下标 [0, n) 中素数的个数，即 3 到 2n + 1 之间的素数个数
+    if (n == N(0)) return N(0);
+    std::vector<N> factors = sieving_primes(sieve_index_to_number(n - N(1)));
+    std::vector<N> bounds = split_sieve_range(n, threads);
+    std::vector<N> counts(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::vector<char> window(sieve_window_size);
+            N c(0);
+            sift_segmented(window.begin(), N(window.size()),
+                           bounds[t], bounds[t + 1], factors,
+                           [&c](std::vector<char>::iterator first,
+                                std::vector<char>::iterator last, N) {
+                               c += N(std::count(first, last, char(1)));
+                           });
+            counts[t] = c;
+        });
+    }
+    for (std::thread& th : pool) th.join();
+    return std::accumulate(counts.begin(), counts.end(), N(0));
+}
+
+inline void sift_parallel(packed_sieve& s,
+                          unsigned threads = default_sieve_threads()) {
+    // 与 sift(s.begin(), s.size()) 结果相同
+    typedef long long N;
+    N n = N(s.size());
+    if (n == 0) return;
+    std::vector<N> factors = sieving_primes(sieve_index_to_number(n - 1));
+    std::vector<N> bounds = split_sieve_range(n, threads);
+    sieve_word* words = s.data();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::vector<char> window(sieve_window_size);
+            sift_segmented(window.begin(), N(window.size()),
+                           bounds[t], bounds[t + 1], factors,
+                           [words](std::vector<char>::iterator first,
+                                   std::vector<char>::iterator last,
+                                   N offset) {
+                               // offset 是 64 的倍数，窗口按整字写回
+                               pack_bits(first, last, words + offset / 64);
+                           });
+        });
+    }
+    for (std::thread& th : pool) th.join();
+}
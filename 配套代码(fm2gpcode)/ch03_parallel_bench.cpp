@@ -0,0 +1,38 @@
+// -------------------------------------------------------------------
+// ch03_parallel_bench.cpp -- Scaling benchmark for ch03_parallel.h.
+// -------------------------------------------------------------------
+// 用法：ch03_parallel_bench [上界，默认 10^9]
+// 例如 ch03_parallel_bench 10000000000 统计 10^10 以内的素数。
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch03_bitmap.h"
+#include "ch03_segmented.h"
+#include "ch03_parallel.h"
+
+int main(int argc, char* argv[]) {
+  typedef long long N;
+  N limit = argc > 1 ? std::atoll(argv[1]) : N(1000000000);
+  N n = number_to_sieve_index(limit % 2 == 0 ? limit - 1 : limit) + 1;
+  unsigned max_threads = default_sieve_threads();
+
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(max_threads);
+
+  double base = 0;
+  for (unsigned threads : thread_counts) {
+    auto start = std::chrono::high_resolution_clock::now();
+    N count = count_primes_parallel(n, threads) + 1;  // 加上素数 2
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    if (threads == 1) base = duration.count();
+    std::cout << "pi(" << limit << ") = " << count
+              << ", threads = " << threads
+              << ": " << duration.count() << " ms"
+              << ", speedup = " << base / duration.count() << std::endl;
+  }
+}
@@ -0,0 +1,50 @@
+// -------------------------------------------------------------------
+// ch03_presieve_bench.cpp -- sift versus pre-sieved sift at 10^9.
+// -------------------------------------------------------------------
+// 用法：ch03_presieve_bench [上界，默认 10^9]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ch03.h"
+#include "ch03_segmented.h"
+
+template <typename F>
+double time_ms(F f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> duration = end - start;
+  return duration.count();
+}
+
+int main(int argc, char* argv[]) {
+  typedef long long N;
+  N limit = argc > 1 ? std::atoll(argv[1]) : N(1000000000);
+  N n = (limit - 1) / 2;  // 覆盖 3 到 2n + 1 <= limit 的奇数
+
+  std::vector<char> v(n);
+  double t_sift = time_ms([&] { sift(v.begin(), n); });
+  N count_sift = std::count(v.begin(), v.end(), char(1)) + 1;
+  std::cout << "sift:           " << t_sift << " ms, pi = " << count_sift
+            << std::endl;
+
+  double t_presieved = time_ms([&] { sift_presieved(v.begin(), n); });
+  N count_presieved = std::count(v.begin(), v.end(), char(1)) + 1;
+  std::cout << "sift_presieved: " << t_presieved << " ms, pi = "
+            << count_presieved << std::endl;
+
+  std::vector<char> window(sieve_window_size);
+  N count_segmented = 1;
+  double t_segmented = time_ms([&] {
+    sift_segmented(window.begin(), N(window.size()), N(0), n,
+                   [&](std::vector<char>::iterator first,
+                       std::vector<char>::iterator last, N) {
+                     count_segmented += std::count(first, last, char(1));
+                   });
+  });
+  std::cout << "sift_segmented: " << t_segmented << " ms, pi = "
+            << count_segmented << std::endl;
+}
@@ -0,0 +1,47 @@
+// -------------------------------------------------------------------
+// ch03_prime_pi.cpp -- For testing ch03_prime_pi.h.
+// -------------------------------------------------------------------
+// 用法：ch03_prime_pi [x [线程数]]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "ch03.h"
+#include "ch03_bitmap.h"
+#include "ch03_segmented.h"
+#include "ch03_prime_pi.h"
+
+int main(int argc, char* argv[]) {
+  typedef std::int64_t N;
+  // 与 sift 对照
+  N n = 5000000;
+  std::vector<char> v(n);
+  sift(v.begin(), n);
+  N count = 1;
+  bool same = true;
+  for (N i = 0; i < n; ++i) {
+    count += v[i];
+    N m = sieve_index_to_number(i);
+    if (i % 99991 == 0 && (prime_pi(m) != count || prime_pi(m + 1) != count)) {
+      same = false;
+    }
+  }
+  std::cout << "prime_pi agrees with sift below 10^7: " << same << std::endl;
+
+  N x = 1;
+  for (int k = 1; k <= 12; ++k) {
+    x *= 10;
+    std::cout << "prime_pi(10^" << k << ") = " << prime_pi(x) << std::endl;
+  }
+
+  if (argc > 1) {
+    x = std::atoll(argv[1]);
+    unsigned threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    auto start = std::chrono::high_resolution_clock::now();
+    N pi = prime_pi(x, threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << "prime_pi(" << x << ", " << threads << ") = " << pi
+              << ": " << duration.count() << " ms" << std::endl;
+  }
+}
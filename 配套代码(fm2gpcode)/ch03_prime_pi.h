@@ -0,0 +1,262 @@
+// -------------------------------------------------------------------
+// ch03_prime_pi.h -- Sublinear prime counting pi(x) (Meissel-Lehmer)
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// 取 y = x^(1/3)，a = pi(y)，b = pi(sqrt(x))，则
+//
+//     pi(x) = phi(x, a) + a - 1 - P2(x, a),
+//     P2(x, a) = sum_{a < i <= b} (pi(x / p_i) - (i - 1)),
+//
+// 其中 phi(x, a) 是 [1, x] 中不被前 a 个素数整除的数的个数。
+// 由于 p_{a+1}^3 > x，不需要 P3 项。
+//
+// - phi 用递推式 phi(x, a) = phi(x, a - 1) - phi(x / p_a, a - 1) 展开；
+//   a <= 6 时查周期表（周期 2*3*5*7*11*13 = 30030），x 足够小且
+//   p_{a+1}^2 > x 时用 pi 表直接得到 pi(x) - a + 1，较小的 (x, a)
+//   结果缓存起来。
+// - P2 需要 pi(x / p) 一直到 x^(2/3)，用 sift_segmented 分段筛出；
+//   内存只有窗口和 sqrt(x) 以内的素数表。
+// - 多线程模式下，phi 的顶层各项和 P2 的各段分给各线程，
+//   每个线程有自己的 phi 缓存，结果最后求和，无需加锁。
+//
+// 使用前需先包含 ch03.h、ch03_bitmap.h 和 ch03_segmented.h。
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 区间 [0, limit] 上的 pi 查询表：按比特存放的奇数素数表，外加每个
+// 64 位字之前的素数个数
+class pi_table {
+    packed_sieve bits;
+    std::vector<std::uint32_t> prefix;
+    std::int64_t limit;
+
+public:
+    explicit pi_table(std::int64_t limit)
+        : bits(std::size_t(std::max<std::int64_t>(limit - 1, 0) / 2)),
+          limit(limit) {
+        std::int64_t n = std::int64_t(bits.size());
+        sift(bits.begin(), n);
+        std::size_t words = (bits.size() + sieve_word_bits - 1)
+                            / sieve_word_bits;
+        prefix.resize(words + 1);
+        prefix[0] = 1;  // 素数 2
+        for (std::size_t k = 0; k < words; ++k) {
+            prefix[k + 1] = prefix[k] + std::popcount(bits.data()[k]);
+        }
+    }
+
+    std::int64_t max() const { return limit; }
+
+    std::int64_t operator()(std::int64_t x) const {
+        // precondition: x <= max()
+        if (x < 3) return x < 2 ? 0 : 1;
+        std::uint64_t i = std::uint64_t(x - 3) / 2;  // 最后一个要数的下标
+        std::uint64_t k = i / sieve_word_bits;
+        sieve_word w = bits.data()[k]
+                       & (~sieve_word(0) >> (sieve_word_bits - 1
+                                             - i % sieve_word_bits));
+        return prefix[k] + std::popcount(w);
+    }
+};
+
+// phi(x, c)，c <= 6，利用周期 2 * 3 * ... * p_c 查表
+class phi_tiny_table {
+    std::vector<std::uint16_t> table[7];
+    std::int64_t period[7];
+    std::int64_t totient[7];
+
+public:
+    static const int max_a = 6;
+
+    phi_tiny_table() {
+        const int small[6] = {2, 3, 5, 7, 11, 13};
+        period[0] = 1;
+        totient[0] = 1;
+        table[0].assign(1, 0);
+        for (int c = 1; c <= max_a; ++c) {
+            period[c] = period[c - 1] * small[c - 1];
+            totient[c] = totient[c - 1] * (small[c - 1] - 1);
+            // table[c][r] = [1, r] 中与前 c 个素数都互素的数的个数
+            table[c].assign(period[c], 0);
+            std::uint16_t count = 0;
+            for (std::int64_t r = 1; r < period[c]; ++r) {
+                bool coprime = true;
+                for (int j = 0; j < c; ++j) {
+                    if (r % small[j] == 0) { coprime = false; break; }
+                }
+                if (coprime) ++count;
+                table[c][r] = count;
+            }
+        }
+    }
+
+    std::int64_t operator()(std::int64_t x, int c) const {
+        // precondition: 0 <= c <= max_a
+        if (c == 0) return x;
+        return x / period[c] * totient[c] + table[c][x % period[c]];
+    }
+};
+
+class phi_engine {
+    const std::vector<std::int64_t>& primes;  // primes[0] = 2
+    const pi_table& pi;
+    const phi_tiny_table& tiny;
+
+    // 缓存 x < cache_x 且 a < cache_a 时的 phi(x, a)
+    static const std::int64_t cache_x = 1 << 16;
+    static const std::int64_t cache_a = 100;
+    std::vector<std::vector<std::int32_t>> cache;
+
+public:
+    phi_engine(const std::vector<std::int64_t>& primes, const pi_table& pi,
+               const phi_tiny_table& tiny)
+        : primes(primes), pi(pi), tiny(tiny), cache(cache_a) {}
+
+    std::int64_t operator()(std::int64_t x, std::int64_t a) {
+        if (a <= phi_tiny_table::max_a) return tiny(x, int(a));
+        // x < p_{a+1}：只剩下 1
+        if (x < primes[a]) return x >= 1 ? 1 : 0;
+        // p_{a+1}^2 > x：x 以内的合数都有前 a 个素数中的因子
+        if (x <= pi.max() && x < primes[a] * primes[a]) {
+            return pi(x) - a + 1;
+        }
+        bool cacheable = x < cache_x && a < cache_a;
+        if (cacheable) {
+            if (cache[a].empty()) cache[a].assign(cache_x, -1);
+            if (cache[a][x] >= 0) return cache[a][x];
+        }
+        std::int64_t sum = tiny(x, phi_tiny_table::max_a)
+                           - terms(x, phi_tiny_table::max_a + 1, a + 1);
+        if (cacheable) cache[a][x] = std::int32_t(sum);
+        return sum;
+    }
+
+    std::int64_t terms(std::int64_t x, std::int64_t first, std::int64_t last) {
+        // sum_{first <= i < last} phi(x / p_i, i - 1)
+        std::int64_t sum = 0;
+        for (std::int64_t i = first; i < last; ++i) {
+            std::int64_t p = primes[i - 1];
+            std::int64_t y = x / p;
+            // y < p_i 时 phi(y, i - 1) = 1，而且之后各项也都如此
+            if (y < p) return sum + (last - i);
+            sum += (*this)(y, i - 1);
+        }
+        return sum;
+    }
+};
+
+inline std::int64_t integer_cbrt(std::int64_t x) {
+    std::int64_t r = std::int64_t(std::cbrt(double(x)));
+    while (r > 0 && r * r * r > x) --r;
+    while ((r + 1) * (r + 1) * (r + 1) <= x) ++r;
+    return r;
+}
+
+inline std::vector<std::int64_t> split_prime_pi_range(std::int64_t n,
+                                                      unsigned parts) {
+    std::vector<std::int64_t> bounds(parts + 1);
+    for (unsigned t = 0; t <= parts; ++t) bounds[t] = n * t / parts;
+    return bounds;
+}
+
+inline std::int64_t prime_pi_p2(std::int64_t x,
+                                const std::vector<std::int64_t>& primes,
+                                std::int64_t a, std::int64_t b,
+                                unsigned threads) {
+    // P2(x, a) = sum_{a < i <= b} (pi(x / p_i) - (i - 1))
+    typedef std::int64_t N;
+    if (a >= b) return 0;
+    // x / p_i 随 i 减小而增大；bounds 按升序排列
+    std::vector<N> bounds;
+    for (N i = b; i > a; --i) bounds.push_back(x / primes[i - 1]);
+    N n = number_to_sieve_index(bounds.back() | 1) + 1;
+
+    // 每个线程筛一段奇数下标，对每个 bound 统计本段中不超过它的素数
+    std::vector<N> parts = split_prime_pi_range(n, threads);
+    std::vector<N> sums(threads);
+    std::vector<N> factors = sieving_primes(sieve_index_to_number(n - 1));
+    auto work = [&](unsigned t) {
+        std::vector<char> window(sieve_window_size);
+        std::size_t k = std::lower_bound(bounds.begin(), bounds.end(),
+                                         sieve_index_to_number(parts[t]))
+                        - bounds.begin();
+        N count = 0;
+        N sum = 0;
+        sift_segmented(window.begin(), N(window.size()),
+                       parts[t], parts[t + 1], factors,
+                       [&](std::vector<char>::iterator first,
+                           std::vector<char>::iterator last, N offset) {
+                           N last_number =
+                               sieve_index_to_number(offset + (last - first)
+                                                     - 1);
+                           while (k < bounds.size() &&
+                                  bounds[k] <= last_number) {
+                               N m = (bounds[k] - 3) / 2 - offset + 1;
+                               sum += count + std::count(first, first + m,
+                                                         char(1));
+                               ++k;
+                           }
+                           count += std::count(first, last, char(1));
+                       });
+        sums[t] = sum + count * N(bounds.size() - k);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (std::thread& th : pool) th.join();
+
+    N sum = 0;
+    for (N s : sums) sum += s;
+    sum += N(bounds.size());  // 每个 pi(x / p_i) 都包含素数 2
+    for (N i = a + 1; i <= b; ++i) sum -= i - 1;
+    return sum;
+}
+
+inline std::int64_t prime_pi(std::int64_t x, unsigned threads = 1) {
+    typedef std::int64_t N;
+    if (x < 2) return 0;
+    N sqrt_x = integer_sqrt(x);
+    pi_table pi(std::max<N>(sqrt_x, 100));
+    if (x <= pi.max()) return pi(x);
+
+    std::vector<N> primes(1, 2);
+    std::vector<N> odd = sieving_primes(x);
+    primes.insert(primes.end(), odd.begin(), odd.end());
+
+    N y = integer_cbrt(x);
+    N a = pi(y);
+    N b = pi(sqrt_x);
+
+    phi_tiny_table tiny;
+    N phi;
+    if (a <= phi_tiny_table::max_a) {
+        phi = tiny(x, int(a));
+    } else {
+        // 顶层各项 phi(x / p_i, i - 1) 互不依赖，由各线程动态领取
+        std::atomic<N> next_i(phi_tiny_table::max_a + 1);
+        std::vector<N> partial(threads);
+        auto work = [&](unsigned t) {
+            phi_engine engine(primes, pi, tiny);
+            N sum = 0;
+            const N chunk = 16;
+            while (true) {
+                N i = next_i.fetch_add(chunk);
+                if (i > a) break;
+                sum += engine.terms(x, i, std::min(i + chunk, a + 1));
+            }
+            partial[t] = sum;
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+        work(0);
+        for (std::thread& th : pool) th.join();
+        phi = tiny(x, phi_tiny_table::max_a);
+        for (N s : partial) phi -= s;
+    }
+    return phi + a - 1 - prime_pi_p2(x, primes, a, b, threads);
+}
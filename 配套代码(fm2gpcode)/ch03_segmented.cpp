@@ -0,0 +1,57 @@
+// -------------------------------------------------------------------
+// ch03_segmented.cpp -- For testing ch03_segmented.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch03_segmented.h"
+
+int main() {
+  typedef long long N;
+
+  // 用 sift 计算的结果作为对照
+  N n = 5000000;
+  std::vector<char> v(n);
+  sift(v.begin(), n);
+  N expected = std::count(v.begin(), v.end(), char(1));
+
+  std::vector<char> w(n);
+  sift_presieved(w.begin(), n);
+  std::cout << "sift_presieved(begin(w), n) == sift(begin(v), n): "
+            << (w == v) << std::endl;
+
+  std::vector<char> window(sieve_window_size);
+  N count = 0;
+  sift_segmented(window.begin(), N(window.size()), N(0), n,
+                 [&](std::vector<char>::iterator first,
+                     std::vector<char>::iterator last, N) {
+                   count += std::count(first, last, char(1));
+                 });
+  std::cout << "odd primes below " << sieve_index_to_number(n)
+            << ": sift = " << expected
+            << ", sift_segmented = " << count << std::endl;
+
+  // 接近类型上限时 double 会向上舍入，integer_sqrt 不能因此溢出
+  std::uint64_t big = ~std::uint64_t(0);
+  std::uint64_t square = std::uint64_t(4294967291) * 4294967291;
+  std::cout << "integer_sqrt(2^64 - 1) = " << integer_sqrt(big)
+            << ", integer_sqrt(4294967291^2) = " << integer_sqrt(square)
+            << ", integer_sqrt(4294967291^2 - 1) = " << integer_sqrt(square - 1)
+            << ", integer_sqrt(2^63 - 1) = "
+            << integer_sqrt(std::int64_t(big >> 1)) << std::endl;
+
+  // 从任意位置开始：列出 [10^12, 10^12 + 200) 中的素数
+  N lo = number_to_sieve_index(N(1000000000001));
+  N hi = lo + 100;
+  std::cout << "primes in [10^12, 10^12 + 200):";
+  sift_segmented(window.begin(), N(64), lo, hi,
+                 [](std::vector<char>::iterator first,
+                    std::vector<char>::iterator last, N offset) {
+                   for (N i = offset; first != last; ++first, ++i) {
+                     if (*first) std::cout << " " << sieve_index_to_number(i);
+                   }
+                 });
+  std::cout << std::endl;
+}
@@ -0,0 +1,168 @@
+// -------------------------------------------------------------------
+// ch03_segmented.h -- Segmented sieve built on sift and mark_sieve
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// 分段筛：先用 sift 筛出 sqrt(n) 以内的奇素数，再把奇数下标空间
+// [lo, hi) 切成固定大小的窗口，逐个窗口调用 mark_sieve。窗口大小取
+// L1/L2 缓存量级时，几乎所有写操作都命中缓存，内存占用与区间长度无关。
+// 每个窗口先用小素数的预筛模式填充，mark_sieve 只处理大于 13 的因子。
+//
+// 下标约定与 sift 相同：下标 i 对应奇数 2i + 3。
+// 使用前需先包含 ch03.h。
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#define RandomAccessIterator typename
+#define Integer typename
+#define Procedure typename
+
+template <Integer N>
+N sieve_index_to_number(N i) {
+    return i + i + N(3);
+}
+
+template <Integer N>
+N number_to_sieve_index(N m) {
+    // precondition: m is odd && m >= 3
+    return (m - N(3)) / N(2);
+}
+
+template <Integer N>
+N integer_sqrt(N m) {
+    // precondition: m >= 0
+    // 先用浮点数估算，再修正到 floor(sqrt(m))。m 接近类型上限时 double(m)
+    // 会向上舍入（例如 std::uint64_t 的 2^64 - 1 变成 2^64），估算值先限制
+    // 在 2^ceil(digits / 2) - 1 以内；修正时用除法比较，不会溢出
+    if (m < N(2)) return m;
+    const N limit = (N(1) << ((std::numeric_limits<N>::digits + 1) / 2)) - N(1);
+    N r(std::min(std::sqrt(double(m)), double(limit)));
+    while (r > m / r) --r;
+    while (r + N(1) <= m / (r + N(1))) ++r;
+    return r;
+}
+
+// 返回所有满足 p * p <= m 的奇素数 p
+template <Integer N>
+std::vector<N> sieving_primes(N m) {
+    N r = integer_sqrt(m);
+    N n = r < N(3) ? N(0) : number_to_sieve_index(r) + N(1);
+    std::vector<char> v(n);
+    sift(v.begin(), n);
+    std::vector<N> primes;
+    for (N i(0); i < n; ++i) {
+        if (v[i]) primes.push_back(sieve_index_to_number(i));
+    }
+    return primes;
+}
+
+// 预筛：奇数下标空间中，3、5、7、11、13 的倍数以 3 * 5 * 7 * 11 * 13
+// 为周期重复出现。把一个周期的模式预先算好，筛每一块时先整块复制
+// （std::copy 对 char 会编译成宽向量拷贝），再交给 mark_sieve 处理
+// 更大的因子，省掉了代价最高的五轮逐个写入。
+const int presieve_period = 3 * 5 * 7 * 11 * 13;
+const int presieve_largest_prime = 13;
+
+inline const std::vector<char>& presieve_pattern() {
+    static const std::vector<char> pattern = [] {
+        std::vector<char> v(presieve_period, true);
+        for (int p : {3, 5, 7, 11, 13}) {
+            // 下标 (p - 3) / 2 对应 p 本身，此后每隔 p 个下标是 p 的倍数
+            for (int i = (p - 3) / 2; i < presieve_period; i += p) v[i] = false;
+        }
+        return v;
+    }();
+    return pattern;
+}
+
+template <RandomAccessIterator I, Integer N>
+void presieve(I first, N n, N lo) {
+    // 等价于 std::fill(first, first + n, true)，再划掉下标 [lo, lo + n)
+    // 中 3 到 13 的倍数（但保留这几个素数本身）
+    const std::vector<char>& pattern = presieve_pattern();
+    I f = first;
+    I last = first + n;
+    N r = lo % N(presieve_period);
+    while (f != last) {
+        N k = std::min(N(presieve_period) - r, N(last - f));
+        f = std::copy(pattern.begin() + r, pattern.begin() + (r + k), f);
+        r = N(0);
+    }
+    for (int p : {3, 5, 7, 11, 13}) {
+        N i = number_to_sieve_index(N(p));
+        if (lo <= i && i < lo + n) first[i - lo] = true;
+    }
+}
+
+template <RandomAccessIterator I, Integer N>
+void sift_presieved(I first, N n) {
+    // 结果与 sift(first, n) 相同
+    I last = first + n;
+    presieve(first, n, N(0));
+    N i(7);
+    N index_square(143);
+    N factor(17);
+    while (index_square < n) {
+        // invariant: index_square = 2i^2 + 6i + 3, factor = 2i + 3
+        if (first[i]) mark_sieve(first + index_square, last, factor);
+        ++i;
+        index_square += factor;
+        factor += N(2);
+        index_square += factor;
+    }
+}
+
+template <Integer N>
+N sieve_start_index(N p, N lo) {
+    // 不小于 lo 的第一个需要被 p 划掉的下标：从 p^2 的下标开始，步长为 p
+    N index_square = number_to_sieve_index(p * p);
+    if (index_square >= lo) return index_square;
+    N r = (lo - index_square) % p;
+    return r == N(0) ? lo : lo + (p - r);
+}
+
+// 常用窗口大小：32 KiB 的 char 数组正好放进 L1 数据缓存
+const int sieve_window_size = 1 << 15;
+
+template <RandomAccessIterator I, Integer N, Procedure F>
+void sift_segmented(I first, N window, N lo, N hi,
+                    const std::vector<N>& factors, F f) {
+    // precondition: [first, first + window) is writable && window > 0
+    //               && lo <= hi && factors contains every odd prime p
+    //               with p * p <= 2(hi - 1) + 3
+    // 每个素数下一个待划掉的下标
+    std::vector<N> next(factors.size());
+    for (std::size_t j = 0; j < factors.size(); ++j) {
+        next[j] = sieve_start_index(factors[j], lo);
+    }
+
+    while (lo < hi) {
+        N n = std::min(window, hi - lo);
+        N end = lo + n;
+        I last = first + n;
+        presieve(first, n, lo);
+        for (std::size_t j = 0; j < factors.size(); ++j) {
+            if (factors[j] <= N(presieve_largest_prime)) continue;
+            N p = factors[j];
+            if (next[j] < end) {
+                mark_sieve(first + (next[j] - lo), last, p);
+                next[j] += (end - next[j] + p - N(1)) / p * p;
+            }
+        }
+        f(first, last, lo);
+        lo = end;
+    }
+}
+
+template <RandomAccessIterator I, Integer N, Procedure F>
+void sift_segmented(I first, N window, N lo, N hi, F f) {
+    // precondition: [first, first + window) is writable && window > 0
+    //               && lo <= hi
+    // 对每个窗口调用 f(first, last, offset)，其中 *(first + k) 表示
+    // 奇数 2(offset + k) + 3 是否为素数
+    if (lo == hi) return;
+    sift_segmented(first, window, lo, hi,
+                   sieving_primes(sieve_index_to_number(hi - N(1))), f);
+}
@@ -0,0 +1,67 @@
+// -------------------------------------------------------------------
+// ch03_table.cpp -- For testing ch03_table.h.
+// -------------------------------------------------------------------
+
+#include <cstdio>
+#include <iostream>
+#include "ch03.h"
+#include "ch03_bitmap.h"
+#include "ch03_segmented.h"
+#include "ch03_file_descriptor.h"
+#include "ch03_table.h"
+
+int main() {
+  const char* path = "primes.fm2gp";
+  build_prime_table(path, 5000000);  // 10^7 以内
+  {
+    prime_table t(path);
+    std::cout << "limit() = " << t.limit() << std::endl;
+    std::cout << "is_prime(9999991) = " << t.is_prime(9999991) << std::endl;
+    std::cout << "is_prime(9999993) = " << t.is_prime(9999993) << std::endl;
+    std::cout << "next_prime(1000000) = " << t.next_prime(1000000) << std::endl;
+    std::cout << "count_primes(0, 10000000) = "
+              << t.count_primes(0, 10000000) << std::endl;
+    std::cout << "count_primes(100, 200) = " << t.count_primes(100, 200)
+              << std::endl;
+    std::cout << "next_prime(t.limit()) = " << t.next_prime(t.limit())
+              << std::endl;
+  }
+
+  extend_prime_table(path, 50000000);  // 扩展到 10^8 以内
+  {
+    prime_table t(path);
+    std::cout << "after extend_prime_table: limit() = " << t.limit()
+              << ", count_primes(0, 100000000) = "
+              << t.count_primes(0, 100000000) << std::endl;
+    std::cout << "count_primes(10000000, 100000000) = "
+              << t.count_primes(10000000, 100000000) << std::endl;
+  }
+  std::remove(path);
+
+  // 不是素数表的文件：每次都抛出异常，描述符不能泄漏
+  const char* bogus = "bogus.fm2gp";
+  std::FILE* f = std::fopen(bogus, "w");
+  std::fputs("not a prime table", f);
+  std::fclose(f);
+  int before = ::dup(1);
+  ::close(before);
+  int failures = 0;
+  for (int i = 0; i < 1000; ++i) {
+    try {
+      prime_table t(bogus);
+    } catch (const std::runtime_error&) {
+      ++failures;
+    }
+    try {
+      extend_prime_table(bogus, 100);
+    } catch (const std::runtime_error&) {
+      ++failures;
+    }
+  }
+  int after = ::dup(1);
+  ::close(after);
+  std::cout << "bogus file rejected " << failures
+            << " times without leaking descriptors: " << (after == before)
+            << std::endl;
+  std::remove(bogus);
+}
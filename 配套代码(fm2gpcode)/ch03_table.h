@@ -0,0 +1,182 @@
+// -------------------------------------------------------------------
+// ch03_table.h -- Persistent, memory-mapped prime table
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// 文件格式：64 字节的文件头之后紧跟按比特存放的奇数素数表，比特 i
+// 表示 2i + 3 是否为素数，与 packed_sieve 的布局完全相同（64 位字，
+// 本机字节序）。
+//
+//     偏移  长度  内容
+//     0     8     magic "FM2GPPT"
+//     8     4     version（当前为 1）
+//     12    4     encoding（1 = 奇数比特表）
+//     16    8     size：表中比特数，覆盖 3 到 2 * size + 1 的奇数
+//     24    40    保留，填 0
+//
+// build_prime_table 生成文件，extend_prime_table 把已有的表追加到更大
+// 的范围。prime_table 用 mmap 只读映射文件，不做任何拷贝，多个进程
+// 打开同一个文件时共享同一批物理页；查询直接在映射页上完成。
+// 使用前需先包含 ch03.h、ch03_bitmap.h、ch03_segmented.h 和
+// ch03_file_descriptor.h。
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct prime_table_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t encoding;
+    std::uint64_t size;
+    std::uint8_t reserved[40];
+};
+
+static_assert(sizeof(prime_table_header) == 64, "header must be 64 bytes");
+
+const char prime_table_magic[8] = "FM2GPPT";
+const std::uint32_t prime_table_version = 1;
+const std::uint32_t prime_table_odd_bitmap = 1;
+
+inline void prime_table_error(const std::string& path, const char* what) {
+    throw std::runtime_error(path + ": " + what);
+}
+
+inline void write_all(int fd, const void* p, std::size_t n, off_t offset,
+                      const std::string& path) {
+    const char* c = static_cast<const char*>(p);
+    while (n != 0) {
+        ssize_t k = ::pwrite(fd, c, n, offset);
+        if (k <= 0) prime_table_error(path, "write failed");
+        c += k;
+        n -= std::size_t(k);
+        offset += k;
+    }
+}
+
+inline void sift_into_table(int fd, std::uint64_t lo, std::uint64_t hi,
+                            const std::string& path) {
+    // 筛下标 [lo, hi) 并写到文件中对应的位置；lo 必须是 64 的倍数
+    typedef long long N;
+    std::vector<char> window(sieve_window_size);
+    std::vector<sieve_word> words(sieve_window_size / sieve_word_bits);
+    sift_segmented(window.begin(), N(window.size()), N(lo), N(hi),
+                   [&](std::vector<char>::iterator first,
+                       std::vector<char>::iterator last, N offset) {
+                       sieve_word* end = pack_bits(first, last, words.data());
+                       write_all(fd, words.data(),
+                                 (end - words.data()) * sizeof(sieve_word),
+                                 sizeof(prime_table_header) + offset / 8,
+                                 path);
+                   });
+}
+
+inline prime_table_header read_prime_table_header(int fd,
+                                                  const std::string& path) {
+    prime_table_header h;
+    if (::pread(fd, &h, sizeof(h), 0) != ssize_t(sizeof(h)) ||
+        std::memcmp(h.magic, prime_table_magic, sizeof(h.magic)) != 0) {
+        prime_table_error(path, "not a prime table");
+    }
+    if (h.version != prime_table_version ||
+        h.encoding != prime_table_odd_bitmap) {
+        prime_table_error(path, "unsupported prime table version or encoding");
+    }
+    return h;
+}
+
+inline void build_prime_table(const std::string& path, std::uint64_t size) {
+    // 生成覆盖 3 到 2 * size + 1 的素数表
+    file_descriptor file(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644));
+    int fd = file.get();
+    if (fd < 0) prime_table_error(path, "cannot create");
+    prime_table_header h = {};
+    std::memcpy(h.magic, prime_table_magic, sizeof(h.magic));
+    h.version = prime_table_version;
+    h.encoding = prime_table_odd_bitmap;
+    h.size = 0;
+    write_all(fd, &h, sizeof(h), 0, path);
+    sift_into_table(fd, 0, size, path);
+    // 数据写完后才更新 size，中途失败的文件仍然是一张合法的空表
+    h.size = size;
+    write_all(fd, &h, sizeof(h), 0, path);
+}
+
+inline void extend_prime_table(const std::string& path, std::uint64_t size) {
+    // 把已有的表扩展到 size 个比特；只筛新增的部分
+    file_descriptor file(::open(path.c_str(), O_RDWR));
+    int fd = file.get();
+    if (fd < 0) prime_table_error(path, "cannot open");
+    prime_table_header h = read_prime_table_header(fd, path);
+    if (size > h.size) {
+        // 从旧表最后一个不完整的字开始重筛，使写入按字对齐
+        std::uint64_t lo = h.size / sieve_word_bits * sieve_word_bits;
+        sift_into_table(fd, lo, size, path);
+        h.size = size;
+        write_all(fd, &h, sizeof(h), 0, path);
+    }
+}
+
+class prime_table {
+    void* map;
+    std::size_t map_size;
+    const sieve_word* words;
+    std::uint64_t n;
+
+public:
+    explicit prime_table(const std::string& path) {
+        file_descriptor file(::open(path.c_str(), O_RDONLY));
+        int fd = file.get();
+        if (fd < 0) prime_table_error(path, "cannot open");
+        prime_table_header h = read_prime_table_header(fd, path);
+        n = h.size;
+        map_size = sizeof(h) + (n + sieve_word_bits - 1) / sieve_word_bits
+                               * sizeof(sieve_word);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || std::uint64_t(st.st_size) < map_size) {
+            prime_table_error(path, "truncated prime table");
+        }
+        map = ::mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) prime_table_error(path, "mmap failed");
+        words = reinterpret_cast<const sieve_word*>(
+            static_cast<const char*>(map) + sizeof(h));
+    }
+
+    ~prime_table() { ::munmap(map, map_size); }
+
+    prime_table(const prime_table&) = delete;
+    prime_table& operator=(const prime_table&) = delete;
+
+    // 表中最大的奇数
+    std::uint64_t limit() const { return 2 * n + 1; }
+
+    bool is_prime(std::uint64_t m) const {
+        // precondition: m <= limit()
+        if (m < 3) return m == 2;
+        if (m % 2 == 0) return false;
+        std::uint64_t i = (m - 3) / 2;
+        return (words[i / sieve_word_bits] >> (i % sieve_word_bits)) & 1;
+    }
+
+    std::uint64_t next_prime(std::uint64_t x) const {
+        // 大于 x 的最小素数；超出表的范围时返回 0
+        if (x < 2) return 2;
+        std::uint64_t i = find_next_bit(words, n, (x - 1) / 2);
+        return i == n ? 0 : 2 * i + 3;
+    }
+
+    std::uint64_t count_primes(std::uint64_t lo, std::uint64_t hi) const {
+        // [lo, hi) 中素数的个数
+        // precondition: hi <= limit() + 1
+        if (lo >= hi) return 0;
+        std::uint64_t c = lo <= 2 && 2 < hi;
+        std::uint64_t first = lo < 3 ? 0 : (lo - 2) / 2;
+        std::uint64_t last = hi < 3 ? 0 : (hi - 2) / 2;
+        return c + count_bits(words, first, last);
+    }
+};
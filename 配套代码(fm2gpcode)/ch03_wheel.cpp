@@ -0,0 +1,40 @@
+// -------------------------------------------------------------------
+// ch03_wheel.cpp -- For testing ch03_wheel.h.
+// -------------------------------------------------------------------
+
+#include <bit>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch03_wheel.h"
+
+int main() {
+  typedef long long N;
+
+  std::vector<unsigned char> w(7);
+  sift_wheel(w.begin(), N(7));
+  std::cout << "sift_wheel(begin(w), 7):\n2 3 5";
+  for (N i = 0; i < 8 * 7; ++i) {
+    if (w[i / 8] & (1u << (i % 8))) {
+      std::cout << " " << wheel_index_to_number(i);
+    }
+  }
+  std::cout << std::endl;
+
+  std::cout << "number_to_wheel_index(wheel_index_to_number(100)) = "
+            << number_to_wheel_index(wheel_index_to_number(N(100))) << std::endl;
+
+  // 与 sift 对照：10^8 以内的素数个数
+  N n = 100000000 / 30;
+  std::vector<unsigned char> v(n);
+  sift_wheel(v.begin(), n);
+  N count = 3;  // 2, 3, 5
+  for (unsigned char b : v) count += std::popcount(b);
+  std::vector<char> s(100000000 / 2 - 1);
+  sift(s.begin(), N(s.size()));
+  std::cout << "primes below 10^8: sift_wheel = " << count
+            << ", sift = " << std::count(s.begin(), s.end(), char(1)) + 1
+            << std::endl;
+  std::cout << "bytes used: sift_wheel = " << v.size()
+            << ", sift = " << s.size() << std::endl;
+}
@@ -0,0 +1,75 @@
+// -------------------------------------------------------------------
+// ch03_wheel.h -- Mod-30 wheel sieve alongside sift
+// (extension of Chapter 3 of fM2GP).
+// -------------------------------------------------------------------
+// sift 只去掉了 2 的倍数。轮式筛再去掉 3 和 5 的倍数：与 30 互素的
+// 余数只有 1, 7, 11, 13, 17, 19, 23, 29 这 8 个，正好放进一个字节。
+// 字节 k 的第 j 位表示 30k + wheel_residues[j]；轮下标 i = 8k + j。
+// 每 30 个数只需 8 个比特，而按比特存放的 sift 需要 15 个，
+// 按字节存放时需要 15 个字节。
+
+#include <algorithm>
+#include <cstdint>
+
+#define RandomAccessIterator typename
+#define Integer typename
+
+const unsigned char wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+// wheel_position[r] 是余数 r 在 wheel_residues 中的位置，与 30 不互素时为 -1
+const signed char wheel_position[30] = {
+    -1,  0, -1, -1, -1, -1, -1,  1, -1, -1,
+    -1,  2, -1,  3, -1, -1, -1,  4, -1,  5,
+    -1, -1, -1,  6, -1, -1, -1, -1, -1,  7
+};
+
+template <Integer N>
+N wheel_index_to_number(N i) {
+    return N(30) * (i / N(8)) + N(wheel_residues[i % N(8)]);
+}
+
+template <Integer N>
+N number_to_wheel_index(N m) {
+    // precondition: gcd(m, 30) == 1
+    return N(8) * (m / N(30)) + N(wheel_position[m % N(30)]);
+}
+
+template <RandomAccessIterator I, Integer N>
+void mark_sieve_wheel(I first, I last, N factor, N index) {
+    // precondition: factor = wheel_index_to_number(index) && factor > 5
+    // 划掉所有 factor * q，其中 q >= factor 且与 30 互素。
+    // q 每走完一圈（8 个余数）增加 30，乘积增加 30 * factor，
+    // 即字节下标增加 factor；因此一圈内的 8 个 (字节, 掩码) 只需算一次。
+    N offset[8];
+    unsigned char mask[8];
+    for (int t = 0; t < 8; ++t) {
+        N m = factor * wheel_index_to_number(index + N(t));
+        offset[t] = m / N(30);
+        mask[t] = ~(1u << wheel_position[m % N(30)]);
+    }
+    N n = N(last - first);
+    while (true) {
+        for (int t = 0; t < 8; ++t) {
+            if (offset[t] >= n) return;
+            first[offset[t]] &= mask[t];
+            offset[t] += factor;
+        }
+    }
+}
+
+template <RandomAccessIterator I, Integer N>
+void sift_wheel(I first, N n) {
+    // 筛出 [0, 30n) 中与 30 互素的素数；first 指向 n 个字节
+    std::fill(first, first + n, 0xFF);
+    if (n == N(0)) return;
+    first[0] &= 0xFE;  // 1 不是素数
+    N i(1);
+    N factor(7);
+    while (factor * factor < N(30) * n) {
+        if (first[i / N(8)] & (1u << (i % N(8)))) {
+            mark_sieve_wheel(first, first + n, factor, i);
+        }
+        ++i;
+        factor = wheel_index_to_number(i);
+    }
+}
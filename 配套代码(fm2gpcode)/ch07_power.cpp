@@ -0,0 +1,142 @@
+// -------------------------------------------------------------------
+// ch07_power.cpp -- For testing ch07_power.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch07_power.h"
+
+int main() {
+  typedef std::uint64_t U;
+  std::mt19937_64 random(2015);
+
+  // 加法半群：a^n 就是 n * a
+  fixed_base_power<U, std::plus<U>> times7(7, 20, std::plus<U>(), 3);
+  std::cout << "fixed_base_power(7, plus)(123456) = " << times7(U(123456))
+            << std::endl;
+
+  U p = 4294967291ull;
+  modulo_multiply<U> mod_p(p);
+  fixed_base_power<U, modulo_multiply<U>> g_mod(5, 32, mod_p);
+  bool same = true;
+  for (int i = 0; i < 100000; ++i) {
+    U n = random() % p + 1;
+    if (g_mod(n) != power_semigroup(U(5), n, mod_p)) same = false;
+  }
+  std::cout << "fixed_base_power agrees with power_semigroup mod 2^32 - 5: "
+            << same << std::endl;
+
+  U q = (U(1) << 61) - 1;
+  montgomery_multiply<U> mont_q(q);
+  U g = mont_q.to(3);
+  for (int w : {1, 4, 5, 8}) {
+    fixed_base_power<U, montgomery_multiply<U>> g_mont(g, 61, mont_q, w);
+    same = true;
+    for (int i = 0; i < 100000; ++i) {
+      U n = random() % q + 1;
+      if (g_mont(n) != power_semigroup(g, n, mont_q)) same = false;
+    }
+    std::cout << "fixed_base_power agrees with power_semigroup mod 2^61 - 1 "
+              << "(Montgomery, w = " << w << "): " << same << std::endl;
+  }
+
+  same = true;
+  for (int i = 0; i < 100000; ++i) {
+    U a = random() % p;
+    U n = random() % p + 1;
+    int w = i % power_window_max + 1;
+    if (power_semigroup_window(a, n, mod_p, w) != power_semigroup(a, n, mod_p)
+        || power_semigroup_window(a, n, mod_p) != power_semigroup(a, n, mod_p)) {
+      same = false;
+    }
+  }
+  std::cout << "power_semigroup_window agrees with power_semigroup "
+            << "mod 2^32 - 5: " << same << std::endl;
+
+  typedef unsigned __int128 U128;
+  U128 m127 = (U128(1) << 127) - 1;
+  montgomery_multiply<U128> mont_m127(m127);
+  U128 h = mont_m127.to(3);
+  same = true;
+  for (int i = 0; i < 10000; ++i) {
+    U128 n = (U128(random()) << 64 | random()) % m127 + 1;
+    if (power_semigroup_window(h, n, mont_m127)
+        != power_semigroup(h, n, mont_m127)) {
+      same = false;
+    }
+  }
+  std::cout << "power_semigroup_window agrees with power_semigroup "
+            << "mod 2^127 - 1 (Montgomery): " << same << std::endl;
+  // 费马小定理：3^(p - 1) = 1
+  std::cout << "3^(2^127 - 2) mod 2^127 - 1 == 1: "
+            << (power_semigroup_window(h, m127 - 1, mont_m127) == mont_m127.one)
+            << std::endl;
+
+  // 加法群：power_group_naf(a, n, plus) = n * a
+  same = true;
+  for (int i = 0; i < 100000; ++i) {
+    long long a = (long long)(random() % 2001) - 1000;
+    long long n = (long long)(random() >> 20) - (1ll << 43);
+    int w = i % (power_window_max - 1) + 2;
+    if (power_group_naf(a, n, std::plus<long long>(), w) != n * a) same = false;
+  }
+  std::cout << "power_group_naf(a, n, plus) == n * a: " << same << std::endl;
+  std::cout << "power_group_naf(7, -8, plus) = "
+            << power_group_naf(7, -8, std::plus<int>()) << std::endl;
+  std::cout << "power_group_naf(7, 0, plus) = "
+            << power_group_naf(7, 0, std::plus<int>()) << std::endl;
+
+  // 取负数字时的进位不会让无符号指数溢出
+  std::cout << "power_group_naf(1, 2^64 - 1, plus) == 2^64 - 1: "
+            << (power_group_naf(U(1), ~U(0), std::plus<U>()) == ~U(0))
+            << std::endl;
+
+  // 模素数的乘法群，指数可以为负
+  same = true;
+  for (int i = 0; i < 10000; ++i) {
+    U a = random() % (q - 1) + 1;
+    long long n = (long long)(random() >> 2);
+    U expected = power_semigroup(mont_q.to(a), U(n), mont_q);
+    U x = power_group_naf(mont_q.to(a), n, mont_q);
+    U y = power_group_naf(mont_q.to(a), -n, mont_q);
+    if (x != expected || mont_q(x, y) != mont_q.one) same = false;
+  }
+  std::cout << "power_group_naf mod 2^61 - 1 agrees with power_semigroup, "
+            << "a^n * a^-n = 1: " << same << std::endl;
+
+  // 多个幂的乘积：与逐个 power_monoid 再相乘对照
+  same = true;
+  for (int k : {1, 2, 3, 8, 40, 200, 1000}) {
+    std::vector<U> bases(k);
+    std::vector<U> exponents(k);
+    for (int j = 0; j < k; ++j) {
+      bases[j] = mont_q.to(random());
+      exponents[j] = j % 7 == 3 ? 0 : random() % q;
+    }
+    U expected = mont_q.one;
+    for (int j = 0; j < k; ++j) {
+      expected = mont_q(expected, power_monoid(bases[j], exponents[j], mont_q));
+    }
+    if (multi_power(bases, exponents, mont_q) != expected
+        || multi_power_straus(bases, exponents, mont_q) != expected
+        || multi_power_pippenger(bases, exponents, mont_q, 5) != expected) {
+      same = false;
+    }
+  }
+  std::cout << "multi_power agrees with a product of power_monoid "
+            << "mod 2^61 - 1: " << same << std::endl;
+  std::vector<int> xs = {3, 5, 7};
+  std::vector<int> ns = {10, 0, 4};
+  std::cout << "multi_power({3, 5, 7}, {10, 0, 4}, plus) = "
+            << multi_power(xs, ns, std::plus<int>()) << std::endl;
+  std::cout << "multi_power({}, {}, multiplies) = "
+            << multi_power(std::vector<int>(), std::vector<int>(),
+                           std::multiplies<int>()) << std::endl;
+}
@@ -0,0 +1,369 @@
+// -------------------------------------------------------------------
+// ch07_power.h -- Faster variants of power_semigroup
+// (extension of Chapter 7 of fM2GP).
+// -------------------------------------------------------------------
+// power_semigroup 每次调用都要重新计算底数的各次平方。下面的算法在
+// 不同的场合减少半群运算的次数，对 Op 的要求与 ch07.h 相同。指数只用
+// odd 和 half 访问，因此对任何满足 Integer 的类型都适用。
+// 使用前需先包含 ch07.h。
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#define Regular typename
+#define Integer typename
+#define SemigroupOperation typename
+
+// 固定底数的幂：底数不变、只有指数变化时（例如 Diffie-Hellman 的生成元），
+// 预先算出
+//
+//     a^(d 2^(iw))，0 <= i < ceil(bits / w)，1 <= d < 2^w，
+//
+// 之后把指数按 w 位一组切成数字 d_i，a^n 就是各组 a^(d_i 2^(iw)) 的乘积：
+// 至多 ceil(bits / w) - 1 次运算，没有平方。表的大小为
+// ceil(bits / w) (2^w - 1) 个元素，预计算需要同样多次运算。
+template <Regular A, SemigroupOperation Op>
+// requires (Domain<Op, A>)
+class fixed_base_power {
+    std::vector<A> table;  // table[i (2^w - 1) + d - 1] = a^(d 2^(iw))
+    int w;
+    int digits;
+    Op op;
+
+public:
+    fixed_base_power(const A& a, int bits, Op op, int w = 4)
+        : w(w), digits((bits + w - 1) / w), op(op) {
+        // precondition: bits > 0 && 0 < w < 16
+        int row = (1 << w) - 1;
+        table.reserve(digits * row);
+        A base = a;
+        for (int i = 0; i < digits; ++i) {
+            // invariant: base = a^(2^(iw))
+            table.push_back(base);
+            for (int d = 1; d < row; ++d) {
+                table.push_back(op(table.back(), base));
+            }
+            if (i + 1 < digits) base = op(table.back(), base);  // a^(2^((i+1)w))
+        }
+    }
+
+    int bits() const { return digits * w; }
+    int window() const { return w; }
+
+    template <Integer N>
+    A operator()(N n) const {
+        // precondition: 0 < n < 2^bits()
+        int row = (1 << w) - 1;
+        const A* entry = table.data();
+        bool started = false;
+        A result = table.front();  // 仅用于初始化，started 之前不读
+        for (int i = 0; i < digits && n != N(0); ++i, entry += row) {
+            int d = 0;
+            for (int j = 0; j < w; ++j) {
+                d |= int(odd(n)) << j;  // 不用分支：数字是随机的
+                n = half(n);
+            }
+            if (d == 0) continue;
+            result = started ? op(result, entry[d - 1]) : entry[d - 1];
+            started = true;
+        }
+        return result;
+    }
+};
+
+// 滑动窗口：把指数从低位起重新编码成 n = sum d_i 2^i，其中非零的 d_i 是
+// 小于 2^w 的奇数，相邻两个非零数字之间至少隔 w - 1 个 0。预先算好
+// a, a^3, ..., a^(2^w - 1)，再从高位往低位计算：每一位平方一次，遇到
+// 非零数字乘一次表项。乘法次数从 popcount(n) 降到约 bits / (w + 1)，
+// 代价是 2^(w-1) 次预计算。奇数次幂存放在栈上的定长数组里。
+const int power_window_max = 6;
+
+inline int power_window_size(int bits) {
+    // 使 2^(w-1) + bits / (w + 1) 最小的 w
+    if (bits <= 12) return 1;
+    if (bits <= 24) return 2;
+    if (bits <= 80) return 3;
+    if (bits <= 240) return 4;
+    if (bits <= 672) return 5;
+    return 6;
+}
+
+template <Integer N>
+int bit_length(N n) {
+    // precondition: n >= 0
+    int bits = 0;
+    for (; n != N(0); n = half(n)) ++bits;
+    return bits;
+}
+
+template <Integer N>
+std::vector<unsigned char> sliding_window_digits(N n, int w) {
+    // precondition: n >= 0 && 0 < w <= power_window_max
+    // 返回 digits，digits[i] 是 2^i 位上的数字；最高位的数字非零
+    std::vector<unsigned char> digits(bit_length(n) + w);
+    for (int i = 0; n != N(0); ) {
+        if (!odd(n)) {
+            n = half(n);
+            ++i;
+            continue;
+        }
+        int d = 0;
+        for (int j = 0; j < w; ++j) {
+            d |= int(odd(n)) << j;
+            n = half(n);
+        }
+        digits[i] = d;
+        i += w;
+    }
+    while (!digits.empty() && digits.back() == 0) digits.pop_back();
+    return digits;
+}
+
+template <Regular A, Integer N, SemigroupOperation Op>
+// requires (Domain<Op, A>)
+A power_semigroup_window(A a, N n, Op op, int w) {
+    // precondition: n > 0 && 0 < w <= power_window_max
+    std::vector<unsigned char> digits = sliding_window_digits(n, w);
+
+    A odd_powers[1 << (power_window_max - 1)];  // odd_powers[k] = a^(2k + 1)
+    int table_size = 1 << (w - 1);
+    odd_powers[0] = a;
+    if (table_size > 1) {
+        A square = op(a, a);
+        for (int k = 1; k < table_size; ++k) {
+            odd_powers[k] = op(odd_powers[k - 1], square);
+        }
+    }
+    std::size_t i = digits.size() - 1;
+    A result = odd_powers[digits[i] / 2];
+    while (i != 0) {
+        --i;
+        result = op(result, result);
+        if (digits[i] != 0) result = op(result, odd_powers[digits[i] / 2]);
+    }
+    return result;
+}
+
+template <Regular A, Integer N, SemigroupOperation Op>
+// requires (Domain<Op, A>)
+A power_semigroup_window(A a, N n, Op op) {
+    // precondition: n > 0
+    // 按指数的位数选择窗口宽度
+    return power_semigroup_window(a, n, op, power_window_size(bit_length(n)));
+}
+
+// 有符号数字（wNAF）：群中求逆几乎不花代价时（加法群、椭圆曲线上的点），
+// 数字可以取负，指数改写成 n = sum d_i 2^i，非零的 d_i 是绝对值小于
+// 2^(w-1) 的奇数，相邻两个非零数字之间至少隔 w - 1 个 0。w = 2 就是
+// NAF，非零数字的个数平均为 bits / 3，而二进制是 bits / 2；一般地为
+// bits / (w + 1)，预计算 a, a^3, ..., a^(2^(w-1) - 1) 需要 2^(w-2) 次
+// 运算，负数字用的表项由 inverse_operation(op) 逐项求出。
+#define GroupOperation typename
+
+inline int naf_window_size(int bits) {
+    // 使 2^(w-2) + bits / (w + 1) 最小的 w
+    if (bits <= 12) return 2;
+    if (bits <= 40) return 3;
+    if (bits <= 120) return 4;
+    if (bits <= 336) return 5;
+    return 6;
+}
+
+template <Regular A, Integer N, GroupOperation Op>
+// requires (Domain<Op, A>)
+A power_group_naf(A a, N n, Op op, int w) {
+    // precondition: 2 <= w <= power_window_max
+    if (n < N(0)) {
+        n = -n;
+        a = inverse_operation(op)(a);
+    }
+    if (n == N(0)) return identity_element(op);
+    std::vector<signed char> digits(bit_length(n) + 1);  // digits[i] 是 2^i 位上的数字
+    for (int i = 0; n != N(0); ) {
+        if (!odd(n)) {
+            n = half(n);
+            ++i;
+            continue;
+        }
+        // 取出低 w 位 r，数字是 r 或 r - 2^w 中绝对值较小的那个；
+        // 取负数字时向上进 1（先移位再加，不会溢出）
+        int r = 0;
+        for (int j = 0; j < w; ++j) {
+            r |= int(odd(n)) << j;
+            n = half(n);
+        }
+        if (r < 1 << (w - 1)) {
+            digits[i] = r;
+        } else {
+            digits[i] = r - (1 << w);
+            n = n + N(1);
+        }
+        i += w;
+    }
+    while (digits.back() == 0) digits.pop_back();
+
+    // positive[k] = a^(2k + 1)，negative[k] = a^-(2k + 1)
+    A positive[1 << (power_window_max - 2)];
+    A negative[1 << (power_window_max - 2)];
+    int table_size = 1 << (w - 2);
+    positive[0] = a;
+    if (table_size > 1) {
+        A square = op(a, a);
+        for (int k = 1; k < table_size; ++k) {
+            positive[k] = op(positive[k - 1], square);
+        }
+    }
+    auto inverse = inverse_operation(op);
+    for (int k = 0; k < table_size; ++k) negative[k] = inverse(positive[k]);
+
+    auto entry = [&](int d) -> const A& {
+        return d > 0 ? positive[(d - 1) / 2] : negative[(-d - 1) / 2];
+    };
+    std::size_t i = digits.size() - 1;
+    A result = entry(digits[i]);
+    while (i != 0) {
+        --i;
+        result = op(result, result);
+        if (digits[i] != 0) result = op(result, entry(digits[i]));
+    }
+    return result;
+}
+
+template <Regular A, Integer N, GroupOperation Op>
+// requires (Domain<Op, A>)
+A power_group_naf(A a, N n, Op op) {
+    // 按指数的位数选择窗口宽度
+    int bits = bit_length(n < N(0) ? -n : n);
+    return power_group_naf(a, n, op, naf_window_size(bits));
+}
+
+// 多个幂的乘积 a_0^(n_0) a_1^(n_1) ... a_(k-1)^(n_(k-1))：逐个求幂再相乘
+// 需要 k 条平方链，而所有项其实可以共用一条。项数少时用 Straus 的交错
+// 窗口：每一项按自己的位数选宽度，做滑动窗口编码并预计算奇数次幂，
+// 然后从最高位往下，每一位对累积结果平方一次，再乘上各项在这一位的
+// 表项。项数多时每项的预计算变得不划算，改用 Pippenger 的分桶法：
+// 指数按 c 位一组切开，对每一组把底数按数字放进 2^c - 1 个桶，再用
+// 后缀和一次求出 prod_d B_d^d，代价约为 (bits / c)(k + 2^(c+1))。
+// 两种方法都要求运算满足交换律。
+#define MonoidOperation typename
+
+template <Regular A, Integer N, MonoidOperation Op>
+// requires (Domain<Op, A>)
+A multi_power_straus(const std::vector<A>& bases,
+                     const std::vector<N>& exponents, Op op) {
+    // precondition: bases.size() == exponents.size()
+    //               && every exponent >= 0 && op is commutative
+    std::size_t k = bases.size();
+    std::vector<std::vector<unsigned char>> digits(k);
+    std::vector<std::vector<A>> odd_powers(k);  // odd_powers[j][t] = a_j^(2t + 1)
+    std::size_t length = 0;
+    for (std::size_t j = 0; j < k; ++j) {
+        int w = power_window_size(bit_length(exponents[j]));
+        digits[j] = sliding_window_digits(exponents[j], w);
+        if (digits[j].empty()) continue;
+        length = std::max(length, digits[j].size());
+        int table_size = 1 << (w - 1);
+        odd_powers[j].reserve(table_size);
+        odd_powers[j].push_back(bases[j]);
+        if (table_size > 1) {
+            A square = op(bases[j], bases[j]);
+            for (int t = 1; t < table_size; ++t) {
+                odd_powers[j].push_back(op(odd_powers[j].back(), square));
+            }
+        }
+    }
+    A result = identity_element(op);
+    bool started = false;  // result 仍是单位元时不必平方
+    for (std::size_t i = length; i-- != 0; ) {
+        if (started) result = op(result, result);
+        for (std::size_t j = 0; j < k; ++j) {
+            if (i >= digits[j].size() || digits[j][i] == 0) continue;
+            const A& x = odd_powers[j][digits[j][i] / 2];
+            result = started ? op(result, x) : x;
+            started = true;
+        }
+    }
+    return result;
+}
+
+template <Regular A, Integer N, MonoidOperation Op>
+// requires (Domain<Op, A>)
+A multi_power_pippenger(const std::vector<A>& bases,
+                        const std::vector<N>& exponents, Op op, int c) {
+    // precondition: bases.size() == exponents.size()
+    //               && every exponent >= 0 && op is commutative
+    //               && 0 < c < 16
+    std::size_t k = bases.size();
+    // 每一项按 c 位一组的数字，低位在前
+    std::vector<std::vector<unsigned short>> digits(k);
+    std::size_t windows = 0;
+    for (std::size_t j = 0; j < k; ++j) {
+        for (N n = exponents[j]; n != N(0); ) {
+            int d = 0;
+            for (int t = 0; t < c; ++t) {
+                d |= int(odd(n)) << t;
+                n = half(n);
+            }
+            digits[j].push_back(d);
+        }
+        windows = std::max(windows, digits[j].size());
+    }
+    A identity = identity_element(op);
+    std::vector<A> buckets(std::size_t(1) << c);
+    std::vector<bool> used(buckets.size());
+    A result = identity;
+    bool started = false;
+    for (std::size_t i = windows; i-- != 0; ) {
+        if (started) {
+            for (int t = 0; t < c; ++t) result = op(result, result);
+        }
+        std::fill(used.begin(), used.end(), false);
+        for (std::size_t j = 0; j < k; ++j) {
+            if (i >= digits[j].size() || digits[j][i] == 0) continue;
+            int d = digits[j][i];
+            buckets[d] = used[d] ? op(buckets[d], bases[j]) : bases[j];
+            used[d] = true;
+        }
+        // prod_d B_d^d = prod_d (B_d B_(d+1) ... B_max)：后缀积的积
+        A suffix = identity;
+        A sum = identity;
+        bool nonempty = false;
+        for (std::size_t d = buckets.size() - 1; d != 0; --d) {
+            if (used[d]) suffix = nonempty ? op(suffix, buckets[d]) : buckets[d];
+            if (nonempty) sum = op(sum, suffix);
+            else if (used[d]) sum = suffix;
+            nonempty = nonempty || used[d];
+        }
+        if (!nonempty) continue;
+        result = started ? op(result, sum) : sum;
+        started = true;
+    }
+    return result;
+}
+
+template <Regular A, Integer N, MonoidOperation Op>
+// requires (Domain<Op, A>)
+A multi_power(const std::vector<A>& bases, const std::vector<N>& exponents,
+              Op op) {
+    // precondition: bases.size() == exponents.size()
+    //               && every exponent >= 0 && op is commutative
+    // 按运算次数的估计在两种方法之间选择
+    std::size_t k = bases.size();
+    if (k == 0) return identity_element(op);
+    int bits = 0;
+    for (const N& n : exponents) bits = std::max(bits, bit_length(n));
+    int w = power_window_size(bits);
+    double straus = bits + double(k) * ((1 << (w - 1)) + double(bits) / (w + 1));
+    double pippenger = straus;
+    int best_c = 0;
+    for (int c = 2; c < 16; ++c) {
+        double cost = bits + double((bits + c - 1) / c) * (k + (2 << c));
+        if (cost < pippenger) {
+            pippenger = cost;
+            best_c = c;
+        }
+    }
+    if (best_c == 0) return multi_power_straus(bases, exponents, op);
+    return multi_power_pippenger(bases, exponents, op, best_c);
+}
@@ -0,0 +1,261 @@
+// -------------------------------------------------------------------
+// ch07_power_bench.cpp -- Benchmarks for ch07_power.h against
+// power_semigroup.
+// -------------------------------------------------------------------
+// 用法：ch07_power_bench [每项的次数，默认 10^6]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch07_power.h"
+
+volatile std::uint64_t bench_sink;  // 防止被测的循环被优化掉
+
+template <typename F>
+double time_ns(const std::vector<std::uint64_t>& exponents, F f) {
+  // 每个指数的平均耗时
+  std::uint64_t sink = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint64_t n : exponents) sink += f(n);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> duration = end - start;
+  bench_sink = sink;
+  return duration.count() / exponents.size();
+}
+
+template <typename Op>
+void bench_fixed_base(const char* name, std::uint64_t g, int bits, Op op,
+                      const std::vector<std::uint64_t>& exponents) {
+  typedef std::uint64_t U;
+  std::cout << name << ", " << bits << "-bit exponents:" << std::endl;
+  std::cout << "  power_semigroup:           "
+            << time_ns(exponents, [&](U n) { return power_semigroup(g, n, op); })
+            << " ns" << std::endl;
+  for (int w : {4, 6, 8}) {
+    fixed_base_power<U, Op> power(g, bits, op, w);
+    std::cout << "  fixed_base_power (w = " << w << "):  "
+              << time_ns(exponents, [&](U n) { return power(n); })
+              << " ns" << std::endl;
+  }
+}
+
+// 统计运算次数的包装
+template <typename Op>
+struct counting_operation {
+  Op op;
+  long long* count;
+
+  template <typename A>
+  A operator()(const A& x, const A& y) const {
+    ++*count;
+    return op(x, y);
+  }
+};
+
+void bench_window(int count) {
+  typedef unsigned __int128 U128;
+  std::mt19937_64 random(2015);
+  U128 m = (U128(1) << 127) - 1;
+  montgomery_multiply<U128> mont(m);
+  U128 g = mont.to(3);
+  std::vector<U128> exponents(count);
+  for (U128& n : exponents) n = (U128(random()) << 64 | random()) % m + 1;
+
+  std::cout << "montgomery_multiply mod 2^127 - 1, 127-bit exponents:"
+            << std::endl;
+  auto run = [&](const char* name, auto power) {
+    long long operations = 0;
+    counting_operation<montgomery_multiply<U128>> op = {mont, &operations};
+    U128 sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (U128 n : exponents) sink += power(n, op);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    bench_sink = std::uint64_t(sink);
+    std::cout << "  " << name << duration.count() / count << " ns, "
+              << double(operations) / count << " operations" << std::endl;
+  };
+  run("power_semigroup:               ", [&](U128 n, auto op) {
+    return power_semigroup(g, n, op);
+  });
+  run("power_semigroup_window (auto): ", [&](U128 n, auto op) {
+    return power_semigroup_window(g, n, op);
+  });
+  for (int w = 2; w <= power_window_max; ++w) {
+    std::cout << "  w = " << w << ":";
+    run(" ", [&](U128 n, auto op) {
+      return power_semigroup_window(g, n, op, w);
+    });
+  }
+}
+
+// inverse_operation 转发给被包装的运算
+template <typename Op>
+auto inverse_operation(const counting_operation<Op>& op) {
+  return inverse_operation(op.op);
+}
+
+template <typename Op>
+auto identity_element(const counting_operation<Op>& op) {
+  return identity_element(op.op);
+}
+
+template <typename A, typename Op>
+void bench_naf(const char* name, A a, Op base, int bits, int count) {
+  typedef unsigned __int128 U128;
+  std::mt19937_64 random(2015);
+  std::vector<U128> exponents(count);
+  U128 mask = (U128(1) << bits) - 1;
+  for (U128& n : exponents) n = ((U128(random()) << 64 | random()) & mask) | 1;
+
+  std::cout << name << ", " << bits << "-bit exponents:" << std::endl;
+  auto run = [&](const char* label, auto power) {
+    long long operations = 0;
+    counting_operation<Op> op = {base, &operations};
+    A sink = A(0);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (U128 n : exponents) sink = base(sink, power(n, op));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    bench_sink = std::uint64_t(sink);
+    std::cout << "  " << label << duration.count() / count << " ns, "
+              << double(operations) / count << " operations" << std::endl;
+  };
+  run("power_monoid:           ", [&](U128 n, auto op) {
+    return power_monoid(a, n, op);
+  });
+  run("power_group_naf (w = 2):", [&](U128 n, auto op) {
+    return power_group_naf(a, n, op, 2);
+  });
+  run("power_group_naf (auto): ", [&](U128 n, auto op) {
+    return power_group_naf(a, n, op);
+  });
+}
+
+void bench_multi_power(int count) {
+  typedef unsigned __int128 U128;
+  std::mt19937_64 random(2015);
+  U128 m = (U128(1) << 127) - 1;
+  montgomery_multiply<U128> mont(m);
+  std::cout << "products of k powers mod 2^127 - 1, 127-bit exponents:"
+            << std::endl;
+  for (int k : {2, 8, 64, 512}) {
+    std::vector<U128> bases(k);
+    std::vector<U128> exponents(k);
+    for (U128& x : bases) x = mont.to(U128(random()) << 64 | random());
+    for (U128& n : exponents) n = (U128(random()) << 64 | random()) % m;
+    int repeat = std::max(1, count / k);
+    auto run = [&](const char* label, auto product) {
+      long long operations = 0;
+      counting_operation<montgomery_multiply<U128>> op = {mont, &operations};
+      U128 sink = 0;
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int r = 0; r < repeat; ++r) sink += product(op);
+      auto end = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double, std::micro> duration = end - start;
+      bench_sink = std::uint64_t(sink);
+      std::cout << "  k = " << k << ", " << label << duration.count() / repeat
+                << " us, " << double(operations) / repeat << " operations"
+                << std::endl;
+    };
+    run("power_monoid each: ", [&](auto op) {
+      U128 x = mont.one;
+      for (int j = 0; j < k; ++j) {
+        x = op(x, power_monoid(bases[j], exponents[j], op));
+      }
+      return x;
+    });
+    run("multi_power:       ", [&](auto op) {
+      return multi_power(bases, exponents, op);
+    });
+  }
+}
+
+// 运算代价高时（这里是模 2^61 - 1 的 8 x 8 矩阵乘法），节省的乘法次数
+// 直接体现为时间
+const int matrix_size = 8;
+typedef std::array<std::uint64_t, matrix_size * matrix_size> matrix;
+
+struct matrix_multiply {
+  montgomery_multiply<std::uint64_t> op;
+
+  matrix operator()(const matrix& x, const matrix& y) const {
+    matrix z;
+    std::uint64_t m = op.modulus;
+    for (int i = 0; i < matrix_size; ++i) {
+      for (int j = 0; j < matrix_size; ++j) {
+        std::uint64_t s = 0;
+        for (int k = 0; k < matrix_size; ++k) {
+          std::uint64_t t = op(x[i * matrix_size + k], y[k * matrix_size + j]);
+          s = s >= m - t ? s - (m - t) : s + t;
+        }
+        z[i * matrix_size + j] = s;
+      }
+    }
+    return z;
+  }
+};
+
+void bench_matrix(int count) {
+  typedef std::uint64_t U;
+  std::mt19937_64 random(2015);
+  U q = (U(1) << 61) - 1;
+  matrix_multiply op = {montgomery_multiply<U>(q)};
+  matrix a;
+  for (U& x : a) x = op.op.to(random());
+  std::vector<U> exponents(count);
+  for (U& n : exponents) n = random() % q + 1;
+
+  std::cout << "8 x 8 matrices mod 2^61 - 1, 61-bit exponents:" << std::endl;
+  auto run = [&](const char* name, auto power) {
+    U sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (U n : exponents) sink += power(n)[0];
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> duration = end - start;
+    bench_sink = sink;
+    std::cout << "  " << name << duration.count() / count << " us" << std::endl;
+  };
+  run("power_semigroup:               ",
+      [&](U n) { return power_semigroup(a, n, op); });
+  run("power_semigroup_window (auto): ",
+      [&](U n) { return power_semigroup_window(a, n, op); });
+}
+
+int main(int argc, char* argv[]) {
+  typedef std::uint64_t U;
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::mt19937_64 random(2015);
+
+  U p = 4294967291ull;  // 2^32 - 5
+  std::vector<U> exponents(count);
+  for (U& n : exponents) n = random() % (p - 1) + 1;
+  bench_fixed_base("modulo_multiply mod 2^32 - 5", U(5), 32,
+                   modulo_multiply<U>(p), exponents);
+
+  U q = (U(1) << 61) - 1;
+  for (U& n : exponents) n = random() % (q - 1) + 1;
+  montgomery_multiply<U> mont(q);
+  bench_fixed_base("montgomery_multiply mod 2^61 - 1", mont.to(3), 61,
+                   mont, exponents);
+
+  bench_window(count / 10);
+  bench_matrix(count / 1000);
+  bench_multi_power(count / 10);
+
+  typedef unsigned __int128 U128;
+  bench_naf("std::plus<unsigned __int128>", U128(12345), std::plus<U128>(),
+            120, count);
+  U128 m = (U128(1) << 127) - 1;
+  montgomery_multiply<U128> mont_m(m);
+  bench_naf("montgomery_multiply mod 2^127 - 1", mont_m.to(3), mont_m, 120,
+            count / 10);
+}
@@ -26,6 +26,6 @@
 int main() {
   std::cout << "stein_gcd(96, 84) = " << stein_gcd(96, 84) << std::endl;
   auto x = extended_gcd(96, 84);
-  auto y = (x.second - 96 * x.first) / 84;
-  std::cout << "extended_gcd(96, 84): gcd = " << x.first * 96 + y * 84 << std::endl;
+  std::cout << "extended_gcd(96, 84): x = " << x.first << ", gcd = "
+            << x.second << std::endl;
 }
@@ -60,6 +60,11 @@ N stein_gcd(N m, N n) {
 
 // Section 12.4
 
+// 内置整数类型的 remainder：没有它，gcd<std::uint64_t> 中的 remainder
+// 会找到 <cmath> 的 double 版本
+template <Integer N>
+N remainder(N a, N b) { return a % b; }
+
 template <EuclideanDomain E>
 E gcd(E a, E b) {
     while (b != E(0)) {
@@ -74,6 +79,11 @@ quotient_remainder(int a, int b) {
   return { a / b, a % b };
 }
 
+// 其他内置整数类型的 quotient_remainder：没有它，extended_gcd<long> 会把
+// 参数截断成 int
+template <Integer N>
+std::pair<N, N> quotient_remainder(N a, N b) { return {a / b, a % b}; }
+
 // 定义一个模板函数，模板参数 E 必须满足欧几里得域（Euclidean Domain）的要求
 // 欧几里得域是一种代数结构，支持除法和取余运算
 template <EuclideanDomain E>
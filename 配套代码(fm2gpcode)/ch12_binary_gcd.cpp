@@ -0,0 +1,106 @@
+// -------------------------------------------------------------------
+// ch12_binary_gcd.cpp -- For testing ch12_binary_gcd.h.
+// -------------------------------------------------------------------
+// 在 16、32、64、128 位上与 stein_gcd、extended_gcd 和 multiplicative_inverse
+// 对照；系数用 bigint 检查 ax + by = g，不受溢出影响。
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_bigint.h"
+#include "ch12_binary_gcd.h"
+
+typedef unsigned __int128 U128;
+
+template <typename N>
+bool agrees(N a, N b) {
+  auto [g, x, y] = binary_extended_gcd(a, b);
+  if (g != stein_gcd(a, b) || binary_gcd(a, b) != g) return false;
+  if (g != extended_gcd(a, b).second) return false;
+  if (bigint(a) * bigint(x) + bigint(b) * bigint(y) != bigint(g)) return false;
+  // 系数的范围：|x| <= b，|y| <= a
+  if (b != N(0) && (x > b || x < -b)) return false;
+  if (a != N(0) && (y > a || y < -a)) return false;
+  if (b % 2 == 1 && b > N(1) && a < b
+      && multiplicative_inverse_binary(a, b) != multiplicative_inverse(a, b)) {
+    return false;
+  }
+  return true;
+}
+
+// 随机的 bits 位正数，低位随机清零，使公共的 2 的幂和奇偶性都能覆盖到
+template <typename N>
+N random_value(std::mt19937_64& random, int bits) {
+  U128 r = (U128(random()) << 64) | random();
+  r >>= 128 - bits + random() % (bits / 2);
+  if (random() % 4 == 0) r &= ~U128(0) << (random() % 16);
+  return N(r);
+}
+
+template <typename N>
+bool test_width(std::mt19937_64& random, int bits) {
+  N max = N(~U128(0) >> (129 - bits));  // 2^(bits - 1) - 1
+  std::vector<N> special = {0, 1, 2, 3, 64, max, N(max - 1), N(max / 3)};
+  for (N a : special) {
+    for (N b : special) {
+      if (!agrees(a, b)) return false;
+    }
+  }
+  for (int i = 0; i < 100000; ++i) {
+    N a = random_value<N>(random, bits - 1);
+    N b = random_value<N>(random, bits - 1);
+    N c = random_value<N>(random, bits / 4);
+    if (!agrees(a, b) || !agrees(b, a)) return false;
+    if (c != N(0) && a <= max / c && b <= max / c && !agrees(a * c, b * c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  std::mt19937_64 random(2015);
+
+  std::cout << "binary_gcd(96, 84) = " << binary_gcd(96, 84) << std::endl;
+  auto [g, x, y] = binary_extended_gcd(96, 84);
+  std::cout << "binary_extended_gcd(96, 84): " << x << " * 96 + " << y
+            << " * 84 = " << g << std::endl;
+  std::cout << "multiplicative_inverse_binary(10, 17) = "
+            << multiplicative_inverse_binary(10, 17) << std::endl;
+
+  // 16 位的运算先提升为 int，检查中间结果没有溢出
+  std::cout << "16-bit agrees with stein_gcd, extended_gcd and "
+               "multiplicative_inverse: "
+            << test_width<std::int16_t>(random, 16) << std::endl;
+  std::cout << "32-bit: " << test_width<std::int32_t>(random, 32) << std::endl;
+  std::cout << "64-bit: " << test_width<std::int64_t>(random, 64) << std::endl;
+  std::cout << "128-bit: " << test_width<__int128>(random, 128) << std::endl;
+
+  // 无符号类型：系数是模 2^64 的值
+  bool same = true;
+  for (int i = 0; i < 100000; ++i) {
+    std::uint64_t a = random() >> (i % 64);
+    std::uint64_t b = random() >> (i % 13);
+    auto [g, x, y] = binary_extended_gcd(a, b);
+    if (g != stein_gcd(a, b) || a * x + b * y != g) same = false;
+  }
+  std::cout << "std::uint64_t: ax + by = g (mod 2^64): " << same << std::endl;
+
+  // std::uint16_t 的每一对 (a, b)，b 取奇数
+  same = true;
+  for (std::uint32_t a = 0; a < 65536; a += 7) {
+    for (std::uint32_t b = 1; b < 65536; b += 258) {
+      auto [g, x, y] = binary_extended_gcd(std::uint16_t(a), std::uint16_t(b));
+      if (g != stein_gcd(std::uint16_t(a), std::uint16_t(b))
+          || std::uint16_t(a * x + b * y) != g) {
+        same = false;
+      }
+    }
+  }
+  std::cout << "std::uint16_t: ax + by = g (mod 2^16): " << same << std::endl;
+}
@@ -0,0 +1,221 @@
+// -------------------------------------------------------------------
+// ch12_binary_gcd.h -- Binary gcd and binary extended gcd with
+// trailing-zero counts (extension of Chapter 12 of fM2GP).
+// -------------------------------------------------------------------
+// ch12.h 的 stein_gcd 每次只移掉一位，循环次数等于去掉的 0 的个数，
+// 循环何时结束也难以预测；这里用 trailing_zeros（std::countr_zero）一次
+// 移掉全部末尾的 0，并用掩码代替按大小交换的分支。
+//
+// binary_extended_gcd 返回 (g, x, y)，ax + by = g，不用除法。设 b 为奇数
+// （a、b 的公共因子 2 先提出来，此后总有一个是奇数），照 Kaliski 的
+// “几乎逆元”算法维护
+//
+//     u 2^k = -(-1)^f r a，v 2^k = (-1)^f s a (mod b)，b = us + vr，
+//
+// 其中 u、v 是 stein_gcd 中的两个数。v 移掉 t 位时把 r 左移 t 位（而不是
+// 把 s 逐位除以 2 模 b），k 加 t；v -= u 时 s += r；u、v 交换时 r、s 也
+// 交换，f 取反，交换用掩码完成，不是分支。b = us + vr 说明 r、s 不超过
+// b，不会溢出。结束时 u = g，a x' = g 2^k (mod b)，再用类似 Montgomery
+// 约简的办法每次除以 2^t（t 约为字长的一半）求出 x = x' / 2^k mod b；
+// 最后 y = (g - ax) / b 是精确除法，用 b 模 2^w 的逆元一次乘法得到。
+// 编译器提供 __int128 时也支持 128 位；128 位的 u、v 都只剩一个字以后
+// 改用 std::uint64_t 继续（系数仍是 128 位），binary_gcd 也一样。
+//
+// 对有符号类型 N，x、y 是真正的系数：b 为奇数时 0 <= x < b，否则
+// 0 <= y < a，a、b 都不为 0 时 |x| <= b，|y| <= a；对无符号类型，x、y
+// 是它们模 2^w 的值（与 ch12.h 的 extended_gcd 相同）。
+//
+// multiplicative_inverse_binary 是模数为奇数时的求逆：只需要 x，省去
+// 求 y 的一步。
+//
+// 使用前需先包含 ch12.h。
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#define Integer typename
+#define BinaryInteger typename
+
+template <Integer N>
+struct unsigned_type { typedef std::make_unsigned_t<N> type; };
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct unsigned_type<__int128> { typedef unsigned __int128 type; };
+
+template <>
+struct unsigned_type<unsigned __int128> { typedef unsigned __int128 type; };
+#endif
+
+// 末尾 0 的个数；std::countr_zero 不接受 unsigned __int128
+template <Integer U>
+int trailing_zeros(U n) { return std::countr_zero(n); }
+
+#ifdef __SIZEOF_INT128__
+inline int trailing_zeros(unsigned __int128 n) {
+    std::uint64_t low = std::uint64_t(n);
+    return low != 0 ? std::countr_zero(low)
+                    : 64 + std::countr_zero(std::uint64_t(n >> 64));
+}
+#endif
+
+// gcd(u, v)，u 为奇数
+template <Integer U>
+U binary_gcd_odd(U u, U v) {
+    // precondition: odd(u) && v > 0
+    do {
+        if constexpr (sizeof(U) > sizeof(std::uint64_t)) {
+            // 两个数都只剩一个字时改用 std::uint64_t
+            if (U(u | v) >> 64 == 0) {
+                return binary_gcd_odd(std::uint64_t(u), std::uint64_t(v));
+            }
+        }
+        v >>= trailing_zeros(v);
+        // u = min(u, v)，v = |v - u|，用掩码而不是分支
+        U less = U(0) - U(v < u);
+        U diff = v - u;
+        u += diff & less;
+        v = (diff ^ less) - less;
+    } while (v != U(0));
+    return u;
+}
+
+template <BinaryInteger N>
+N binary_gcd(N m, N n) {
+    // precondition: m >= 0 && n >= 0
+    typedef typename unsigned_type<N>::type U;
+    U u = m;
+    U v = n;
+    if (u == U(0)) return n;
+    if (v == U(0)) return m;
+    int d = trailing_zeros(U(u | v));
+    return N(binary_gcd_odd(U(u >> trailing_zeros(u)), v) << d);
+}
+
+// b 模 2^w 的逆元
+template <Integer U>
+U inverse_mod_power_of_two(U b) {
+    // precondition: b is odd
+    // 牛顿迭代：每次迭代使 b * inverse = 1 (mod 2^k) 的位数翻倍
+    // 比 unsigned 窄的 U 会提升为 int，乘积可能溢出，所以在 W 中计算
+    typedef std::common_type_t<U, unsigned> W;
+    W inverse = b;  // 对奇数 b，b * b = 1 (mod 8)
+    for (int bits = 3; bits < int(sizeof(U) * 8); bits += bits) {
+        inverse *= W(2) - W(b) * inverse;
+    }
+    return U(inverse);
+}
+
+// x / 2^k mod b
+template <Integer U>
+U divide_by_power_of_two(U x, int k, U b, U b_inverse) {
+    // precondition: b is odd && x < b && b * b_inverse = 1 (mod 2^w)
+    // 每次取 t 位：m = -x / b mod 2^t，x + mb 被 2^t 整除，商小于 b。
+    // b 拆成高低两部分，t 不超过 (w - 1) / 2 时中间结果都不会溢出。
+    // 与 inverse_mod_power_of_two 一样在 W 中计算，结果小于 b，截断回 U
+    typedef std::common_type_t<U, unsigned> W;
+    const int chunk = (int(sizeof(U) * 8) - 1) / 2;
+    while (k > 0) {
+        int t = std::min(k, chunk);
+        W mask = (W(1) << t) - 1;
+        W m = (W(0) - W(x) * b_inverse) & mask;
+        x = U((W(x) >> t) + m * (W(b) >> t)
+              + (((W(x) & mask) + m * (W(b) & mask)) >> t));
+        k -= t;
+    }
+    return x;
+}
+
+// almost_cofactor 的主循环，返回 gcd；u、v 的类型 W 可以比系数的类型 U 窄
+template <Integer W, Integer U>
+W almost_cofactor_steps(W u, W v, U& r, U& s, U& f, int& k) {
+    for (;;) {
+        // odd(u) && odd(v) && b = us + vr
+        if constexpr (sizeof(W) > sizeof(std::uint64_t)) {
+            // 系数仍然用 U，u、v 都只剩一个字时改用 std::uint64_t
+            if (W(u | v) >> 64 == 0) {
+                return almost_cofactor_steps(std::uint64_t(u), std::uint64_t(v),
+                                             r, s, f, k);
+            }
+        }
+        bool less = v < u;
+        W du = (u ^ v) & (W(0) - W(less));
+        U swap = U(0) - U(less);
+        U dr = (r ^ s) & swap;
+        u ^= du;
+        v ^= du;
+        r ^= dr;
+        s ^= dr;
+        f ^= swap;
+        v -= u;
+        if (v == W(0)) return u;
+        s += r;
+        int t = trailing_zeros(v);
+        v >>= t;
+        r <<= t;
+        k += t;
+    }
+}
+
+// 返回 g = gcd(a, b)，x、k 满足 a x = g 2^k (mod b)，0 <= x < b
+template <Integer U>
+U almost_cofactor(U a, U b, U& x, int& k) {
+    // precondition: b is odd
+    x = U(0);
+    k = 0;
+    if (a == U(0)) return b;
+    U r(0);   // invariant: u 2^k = -(-1)^f r a (mod b)
+    U s(1);   // invariant: v 2^k = (-1)^f s a (mod b)
+    U f(0);   // f 的掩码：全 0 或全 1
+    k = trailing_zeros(a);
+    U g = almost_cofactor_steps(b, U(a >> k), r, s, f, k);
+    // r <= b / g
+    x = f != U(0) ? r : b - r;
+    if (x >= b) x -= b;
+    return g;
+}
+
+template <Integer N>
+std::tuple<N, N, N> binary_extended_gcd(N a, N b) {
+    // precondition: a >= 0 && b >= 0
+    // 返回 (g, x, y)，g = gcd(a, b)，ax + by = g
+    typedef typename unsigned_type<N>::type U;
+    typedef std::common_type_t<U, unsigned> W;  // 见 inverse_mod_power_of_two
+    U u = a;
+    U v = b;
+    if (v == U(0)) return {a, N(1), N(0)};
+    if (u == U(0)) return {b, N(0), N(1)};
+    int d = trailing_zeros(U(u | v));
+    u >>= d;
+    v >>= d;
+    U g, x, y;
+    int k;
+    if (!even(v)) {
+        U inverse = inverse_mod_power_of_two(v);
+        g = almost_cofactor(u, v, x, k);
+        x = divide_by_power_of_two(x, k, v, inverse);
+        y = U((W(g) - W(u) * x) * inverse);
+    } else {
+        // u 是奇数
+        U inverse = inverse_mod_power_of_two(u);
+        g = almost_cofactor(v, u, y, k);
+        y = divide_by_power_of_two(y, k, u, inverse);
+        x = U((W(g) - W(v) * y) * inverse);
+    }
+    return {N(g << d), N(x), N(y)};
+}
+
+// 奇数模数的乘法逆元；不可逆时返回 0（与 ch13.h 的 multiplicative_inverse
+// 相同）
+template <Integer N>
+N multiplicative_inverse_binary(N a, N n) {
+    // precondition: n is odd && n > 1 && 0 <= a < n
+    typedef typename unsigned_type<N>::type U;
+    U x;
+    int k;
+    if (almost_cofactor(U(a), U(n), x, k) != U(1)) return N(0);
+    return N(divide_by_power_of_two(x, k, U(n), inverse_mod_power_of_two(U(n))));
+}
@@ -0,0 +1,77 @@
+// -------------------------------------------------------------------
+// ch12_binary_gcd_bench.cpp -- Benchmarks for ch12_binary_gcd.h against
+// stein_gcd, extended_gcd and multiplicative_inverse.
+// -------------------------------------------------------------------
+// 用法：ch12_binary_gcd_bench [每项的次数，默认 10^6]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch12_binary_gcd.h"
+
+volatile std::uint64_t bench_sink;  // 防止被测的循环被优化掉
+
+typedef unsigned __int128 U128;
+
+template <typename N, typename F>
+double time_ns(const std::vector<N>& a, const std::vector<N>& b, F f) {
+  // 每对输入的平均耗时
+  std::uint64_t sink = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::size_t i = 0; i < a.size(); ++i) sink += std::uint64_t(f(a[i], b[i]));
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> duration = end - start;
+  bench_sink = sink;
+  return duration.count() / a.size();
+}
+
+template <typename N>
+void bench_width(std::mt19937_64& random, int bits, std::size_t count) {
+  // bits - 1 位的随机正数；b 取奇数，供求逆元用
+  std::vector<N> a(count), b(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    U128 x = (U128(random()) << 64) | random();
+    U128 y = (U128(random()) << 64) | random();
+    a[i] = N(x >> (129 - bits));
+    b[i] = N((y >> (129 - bits)) | 1);
+    if (a[i] >= b[i]) a[i] %= b[i];
+  }
+  std::cout << bits << "-bit inputs (ns per call):" << std::endl;
+  std::cout << "  stein_gcd:                     "
+            << time_ns(a, b, [](N x, N y) { return stein_gcd(x, y); })
+            << std::endl;
+  std::cout << "  binary_gcd:                    "
+            << time_ns(a, b, [](N x, N y) { return binary_gcd(x, y); })
+            << std::endl;
+  std::cout << "  extended_gcd:                  "
+            << time_ns(a, b, [](N x, N y) { return extended_gcd(x, y).first; })
+            << std::endl;
+  std::cout << "  binary_extended_gcd:           "
+            << time_ns(a, b, [](N x, N y) {
+                 return std::get<1>(binary_extended_gcd(x, y));
+               })
+            << std::endl;
+  std::cout << "  multiplicative_inverse:        "
+            << time_ns(a, b, [](N x, N y) { return multiplicative_inverse(x, y); })
+            << std::endl;
+  std::cout << "  multiplicative_inverse_binary: "
+            << time_ns(a, b, [](N x, N y) {
+                 return multiplicative_inverse_binary(x, y);
+               })
+            << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::mt19937_64 random(2015);
+  bench_width<std::int32_t>(random, 32, count);
+  bench_width<std::int64_t>(random, 64, count);
+  bench_width<__int128>(random, 128, count);
+}
@@ -0,0 +1,120 @@
+// -------------------------------------------------------------------
+// ch13_batch_gcd.cpp -- For testing ch13_batch_gcd.h.
+// -------------------------------------------------------------------
+// 用法：ch13_batch_gcd [m]
+// 生成 m 个 256 位的 RSA 模数（默认 4000 个），其中一部分故意共用素数，
+// 检查 batch_gcd 找出的因子，并与两两求 gcd 的结果和耗时对照。
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "ch03_file_descriptor.h"
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_bpsw.h"
+#include "ch13_bigint.h"
+#include "ch13_bigint_gcd.h"
+#include "ch13_batch_gcd.h"
+
+typedef unsigned __int128 U128;
+
+template <typename F>
+double time_ms(F f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> duration = end - start;
+  return duration.count();
+}
+
+// 两两求 gcd：g[i] 是 n_i 与其他各数的 gcd 的最小公倍数
+std::vector<bigint> pairwise_gcd(const std::vector<bigint>& moduli) {
+  std::vector<bigint> g(moduli.size(), bigint(1));
+  for (std::size_t i = 0; i < moduli.size(); ++i) {
+    for (std::size_t j = i + 1; j < moduli.size(); ++j) {
+      bigint d = gcd(moduli[i], moduli[j]);
+      if (d == 1) continue;
+      g[i] = g[i] / gcd(g[i], d) * d;
+      g[j] = g[j] / gcd(g[j], d) * d;
+    }
+  }
+  return g;
+}
+
+int main(int argc, char* argv[]) {
+  std::size_t m = argc > 1 ? std::stoul(argv[1]) : 4000;
+  std::mt19937_64 random(2015);
+
+  // 128 位的随机素数
+  auto random_prime = [&random] {
+    for (;;) {
+      U128 p = (U128(random() | std::uint64_t(1) << 63) << 64) | random() | 1;
+      if (is_probable_prime(p)) return p;
+    }
+  };
+  std::vector<U128> primes(2 * m);
+  for (U128& p : primes) p = random_prime();
+  // 每 50 个模数中有一个借用下一个模数的素数；再放一个重复的模数
+  for (std::size_t i = 0; i + 1 < m; i += 50) primes[2 * i] = primes[2 * i + 2];
+  if (m > 10) {
+    primes[2 * m - 2] = primes[6];
+    primes[2 * m - 1] = primes[7];
+  }
+
+  std::vector<bigint> moduli(m);
+  std::map<U128, int> uses;
+  for (std::size_t i = 0; i < m; ++i) {
+    moduli[i] = bigint(primes[2 * i]) * bigint(primes[2 * i + 1]);
+    if (primes[2 * i] != primes[2 * i + 1]) ++uses[primes[2 * i + 1]];
+    ++uses[primes[2 * i]];
+  }
+  // 期望的结果：n_i 中被其他模数共用的素数之积
+  std::vector<bigint> expected(m, bigint(1));
+  std::size_t shared = 0;
+  for (std::size_t i = 0; i < m; ++i) {
+    for (int k = 0; k < 2; ++k) {
+      if (uses[primes[2 * i + k]] > 1) expected[i] *= bigint(primes[2 * i + k]);
+    }
+    shared += expected[i] != 1;
+  }
+
+  std::vector<bigint> g;
+  double t = time_ms([&] { g = batch_gcd(moduli); });
+  std::cout << m << " moduli, " << shared << " with a shared prime: "
+            << "batch_gcd finds them all: " << (g == expected) << " ("
+            << t << " ms)" << std::endl;
+
+  // 强制把乘积树的每一层都写入临时文件，并用多个线程
+  std::vector<bigint> spilled;
+  int before = ::dup(1);
+  ::close(before);
+  t = time_ms([&] { spilled = batch_gcd(moduli, 4, 0); });
+  bool thrown = false;
+  try {
+    batch_gcd(moduli, 1, 0, "/nonexistent");
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  int after = ::dup(1);
+  ::close(after);
+  std::cout << "same with every level memory-mapped and 4 threads: "
+            << (spilled == g) << " (" << t << " ms)" << std::endl;
+  std::cout << "unwritable spill directory throws: " << thrown
+            << ", no descriptors leaked: " << (after == before) << std::endl;
+
+  // 与两两求 gcd 对照
+  std::vector<bigint> part(moduli.begin(),
+                           moduli.begin() + std::min<std::size_t>(m, 600));
+  std::vector<bigint> slow;
+  double pairwise = time_ms([&] { slow = pairwise_gcd(part); });
+  double batch = time_ms([&] { g = batch_gcd(part); });
+  std::cout << "first " << part.size() << " moduli: pairwise gcd agrees: "
+            << (slow == g) << " (pairwise " << pairwise << " ms, batch "
+            << batch << " ms)" << std::endl;
+}
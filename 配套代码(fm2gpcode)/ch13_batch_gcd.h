@@ -0,0 +1,204 @@
+// -------------------------------------------------------------------
+// ch13_batch_gcd.h -- Bernstein's batch gcd over product and remainder
+// trees (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 给定 n_1, ..., n_m，对每个 i 求 n_i 与其余所有数之积的 gcd，例如检查
+// 一批 RSA 模数中是否有共用的素因子。两两求 gcd 要 m(m - 1) / 2 次；
+// Bernstein 的做法是：
+//
+//   1. 乘积树：叶子是 n_i，每个结点是两个孩子之积，根是 P = n_1 ... n_m；
+//   2. 余数树：根为 P，每个结点是父结点模本结点的平方，叶子得到
+//      P mod n_i^2；
+//   3. g_i = gcd((P mod n_i^2) / n_i, n_i)。
+//
+// 取模的对象是 n_i^2 而不是 n_i，所以 (P mod n_i^2) / n_i 恰好等于
+// (P / n_i) mod n_i。乘法和除法都用快速算法，总代价为 O(M(N) log m)，
+// N 是输入的总长度，M(N) 是 N 个 limb 的乘法的代价。
+//
+// 同一层的结点互不依赖，按层分给多个线程；靠近根的几层结点很少，并行度
+// 也随之下降。乘积树共 log m 层，每层都和输入一样大；超过 spill_limbs
+// 个 limb 的层写入临时文件，再用 mmap 只读映射，由操作系统决定哪些页
+// 留在内存里。余数树自顶向下逐层计算，只需同时保留相邻的两层。
+//
+// 结果：g_i == 1 表示 n_i 与其他数互素；1 < g_i < n_i 时 g_i 是共用的
+// 因子；g_i == n_i 表示 n_i 的素因子全部被共用（例如 n_i 出现了两次）。
+// 使用前需先包含 ch03_file_descriptor.h、ch12.h、ch13_bigint.h 和
+// ch13_bigint_gcd.h。
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 乘积树中超过这个 limb 数（8 MiB）的层写入临时文件
+const std::size_t batch_gcd_spill_limbs = std::size_t(1) << 20;
+
+inline unsigned default_batch_threads() {
+    unsigned t = std::thread::hardware_concurrency();
+    return t == 0 ? 1 : t;
+}
+
+inline std::string default_spill_directory() {
+    const char* d = std::getenv("TMPDIR");
+    return d != nullptr && *d != '\0' ? d : "/tmp";
+}
+
+template <typename F>
+void parallel_for(std::size_t n, unsigned threads, F f) {
+    // 把 [0, n) 切成至多 threads 段，每段一个线程，对每个 i 调用 f(i)
+    std::size_t parts = std::max<std::size_t>(1, std::min<std::size_t>(threads, n));
+    if (parts == 1) {
+        for (std::size_t i = 0; i < n; ++i) f(i);
+        return;
+    }
+    std::size_t step = (n + parts - 1) / parts;
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < parts; ++t) {
+        std::size_t first = std::min(n, t * step);
+        std::size_t last = std::min(n, first + step);
+        pool.emplace_back([first, last, &f] {
+            for (std::size_t i = first; i < last; ++i) f(i);
+        });
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+// 乘积树的一层：在内存中，或在用 mmap 映射的临时文件里
+class tree_level {
+    std::vector<bigint> values;
+    std::vector<std::size_t> offsets;  // 第 i 个数占文件中的 limb [offsets[i], offsets[i + 1])
+    void* map = nullptr;
+    std::size_t map_size = 0;
+
+    static void write_all(int fd, const limb* p, std::size_t n, off_t offset,
+                          const std::string& path) {
+        const char* c = reinterpret_cast<const char*>(p);
+        std::size_t bytes = n * sizeof(limb);
+        while (bytes != 0) {
+            ssize_t k = ::pwrite(fd, c, bytes, offset);
+            if (k <= 0) throw std::runtime_error(path + ": write failed");
+            c += k;
+            bytes -= std::size_t(k);
+            offset += k;
+        }
+    }
+
+    void spill(const std::string& directory) {
+        std::string path = directory + "/batch_gcd_XXXXXX";
+        file_descriptor file(::mkstemp(&path[0]));
+        int fd = file.get();
+        if (fd < 0) throw std::runtime_error(path + ": cannot create");
+        ::unlink(path.c_str());  // 描述符关闭、映射解除后文件自动删除
+        offsets.resize(values.size() + 1);
+        offsets[0] = 0;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            offsets[i + 1] = offsets[i] + values[i].size();
+            write_all(fd, values[i].limbs(), values[i].size(),
+                      off_t(offsets[i] * sizeof(limb)), path);
+        }
+        map_size = offsets.back() * sizeof(limb);
+        map = ::mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            map = nullptr;
+            throw std::runtime_error(path + ": mmap failed");
+        }
+        std::vector<bigint>().swap(values);
+    }
+
+public:
+    tree_level(std::vector<bigint> v, std::size_t spill_limbs,
+               const std::string& directory) : values(std::move(v)) {
+        std::size_t n = 0;
+        for (const bigint& x : values) n += x.size();
+        if (n > spill_limbs && n != 0) spill(directory);
+    }
+
+    tree_level(tree_level&& x) noexcept
+        : values(std::move(x.values)), offsets(std::move(x.offsets)),
+          map(x.map), map_size(x.map_size) {
+        x.map = nullptr;
+    }
+
+    tree_level& operator=(tree_level&& x) noexcept {
+        std::swap(values, x.values);
+        std::swap(offsets, x.offsets);
+        std::swap(map, x.map);
+        std::swap(map_size, x.map_size);
+        return *this;
+    }
+
+    ~tree_level() {
+        if (map != nullptr) ::munmap(map, map_size);
+    }
+
+    tree_level(const tree_level&) = delete;
+    tree_level& operator=(const tree_level&) = delete;
+
+    bool spilled() const { return map != nullptr; }
+
+    std::size_t size() const {
+        return map != nullptr ? offsets.size() - 1 : values.size();
+    }
+
+    bigint operator[](std::size_t i) const {
+        if (map == nullptr) return values[i];
+        const limb* p = static_cast<const limb*>(map);
+        return bigint::from_limbs(p + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+// 乘积树，下标 0 是叶子，最后一层只有根
+inline std::vector<tree_level>
+product_tree(const std::vector<bigint>& leaves, unsigned threads,
+             std::size_t spill_limbs, const std::string& directory) {
+    std::vector<tree_level> tree;
+    tree.emplace_back(leaves, spill_limbs, directory);
+    while (tree.back().size() > 1) {
+        const tree_level& below = tree.back();
+        std::vector<bigint> level((below.size() + 1) / 2);
+        parallel_for(level.size(), threads, [&](std::size_t i) {
+            if (2 * i + 1 < below.size()) {
+                level[i] = below[2 * i] * below[2 * i + 1];
+            } else {
+                level[i] = below[2 * i];
+            }
+        });
+        tree.emplace_back(std::move(level), spill_limbs, directory);
+    }
+    return tree;
+}
+
+inline std::vector<bigint>
+batch_gcd(const std::vector<bigint>& moduli,
+          unsigned threads = default_batch_threads(),
+          std::size_t spill_limbs = batch_gcd_spill_limbs,
+          const std::string& directory = default_spill_directory()) {
+    // precondition: 每个 moduli[i] > 0
+    // 返回 g，g[i] = gcd(moduli[i], 其余各数之积)
+    if (moduli.empty()) return {};
+    std::vector<tree_level> tree = product_tree(moduli, threads, spill_limbs,
+                                                directory);
+    std::vector<bigint> remainders(1, tree.back()[0]);
+    tree.pop_back();
+    while (!tree.empty()) {
+        // invariant: remainders[j] = P mod (上一层第 j 个结点)^2
+        const tree_level& level = tree.back();
+        std::vector<bigint> next(level.size());
+        parallel_for(next.size(), threads, [&](std::size_t i) {
+            bigint n = level[i];
+            next[i] = remainders[i / 2] % (n * n);
+        });
+        remainders = std::move(next);
+        tree.pop_back();
+    }
+    parallel_for(moduli.size(), threads, [&](std::size_t i) {
+        remainders[i] = gcd(remainders[i] / moduli[i], moduli[i]);
+    });
+    return remainders;
+}
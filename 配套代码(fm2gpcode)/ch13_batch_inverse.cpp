@@ -0,0 +1,82 @@
+// -------------------------------------------------------------------
+// ch13_batch_inverse.cpp -- For testing ch13_batch_inverse.h.
+// -------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_batch_inverse.h"
+
+int main() {
+  typedef std::uint64_t U;
+  std::mt19937_64 random(2015);
+
+  // 素数模，用 modulo_multiply；每 100 个元素放一个 0
+  U p = 1000000007;
+  std::vector<U> a(100000);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    a[i] = i % 100 == 0 ? 0 : random() % p;
+  }
+  std::vector<U> b(a.size());
+  std::size_t failures = batch_multiplicative_inverse(a.begin(), a.end(),
+                                                      b.begin(), p);
+  bool same = true;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    U expected = a[i] == 0 ? 0 : multiplicative_inverse_fermat(a[i], p);
+    if (b[i] != expected) same = false;
+  }
+  std::cout << "batch inverses mod 10^9 + 7 agree with "
+            << "multiplicative_inverse_fermat: " << same
+            << ", zeros reported: " << failures << std::endl;
+
+  // 61 位素数模，用 Montgomery 形式的输入和输出
+  U q = (U(1) << 61) - 1;
+  montgomery_multiply<U> op = q;
+  for (U& x : a) x = x == 0 ? 0 : op.to(random() % (q - 1) + 1);
+  failures = batch_multiplicative_inverse(a.begin(), a.end(), b.begin(), q, op);
+  same = true;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i] != 0 && op(a[i], b[i]) != op.one) same = false;
+    if (a[i] == 0 && b[i] != 0) same = false;
+  }
+  std::cout << "Montgomery batch inverses mod 2^61 - 1: x * x^(-1) = 1: "
+            << same << ", zeros reported: " << failures << std::endl;
+
+  // 原地求逆：out == first
+  std::vector<U> g = a;
+  failures = batch_multiplicative_inverse(g.begin(), g.end(), g.begin(), q, op);
+  std::cout << "in place: same as into a separate array: " << (g == b)
+            << ", zeros reported: " << failures << std::endl;
+
+  // 合数模：与 n 不互素的元素没有逆元
+  U n = 1000000;
+  std::vector<U> c = {1, 3, 7, 10, 0, 999999, 12345, 4};
+  std::vector<U> d(c.size());
+  failures = batch_multiplicative_inverse(c.begin(), c.end(), d.begin(), n);
+  std::cout << "inverses mod 10^6:";
+  for (U x : d) std::cout << " " << x;
+  std::cout << " (" << failures << " without inverse)" << std::endl;
+
+  // 耗时：一次批量求逆对比逐个求逆
+  std::vector<U> e(1000000);
+  for (U& x : e) x = op.to(random() % (q - 1) + 1);
+  std::vector<U> f(e.size());
+  auto start = std::chrono::high_resolution_clock::now();
+  batch_multiplicative_inverse(e.begin(), e.end(), f.begin(), q, op);
+  auto middle = std::chrono::high_resolution_clock::now();
+  for (std::size_t i = 0; i < e.size(); ++i) {
+    f[i] = op.to(modular_inverse(op.from(e[i]), q));
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> batch = middle - start;
+  std::chrono::duration<double, std::nano> single = end - middle;
+  std::cout << "10^6 inverses mod 2^61 - 1: batch "
+            << batch.count() / e.size() << " ns, one by one "
+            << single.count() / e.size() << " ns per element" << std::endl;
+}
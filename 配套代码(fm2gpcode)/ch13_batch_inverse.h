@@ -0,0 +1,87 @@
+// -------------------------------------------------------------------
+// ch13_batch_inverse.h -- Batch modular inverses with Montgomery's
+// simultaneous-inversion trick (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 要求 a_0, ..., a_{m-1} 模 n 的逆元时，先算前缀积
+//
+//     c_i = a_0 a_1 ... a_i，
+//
+// 只对 c_{m-1} 求一次逆（一次扩展欧几里得算法），再从后往前展开：
+//
+//     a_i^{-1} = c_i^{-1} c_{i-1}，  c_{i-1}^{-1} = c_i^{-1} a_i。
+//
+// 每个元素共 3 次乘法（前向 1 次，后向 2 次），代替一次完整的 gcd。
+// 前缀积直接存放在输出区间里，不需要额外内存。后向时还要读原来的元素，
+// 所以原地调用（out == first）时先把输入复制一份；输出区间不能与输入
+// 部分重叠。
+//
+// 输入为 0 的元素在前缀积中按 1 处理，输出 0（与 multiplicative_inverse
+// 对不可逆元素的约定相同）。若 n 是合数且有非零元素与 n 不互素，总乘积
+// 不可逆，这时退回到逐个求逆。返回值是没有逆元的元素个数。
+//
+// 带运算参数的版本中，输入和输出都是 op 的剩余类表示（例如 Montgomery
+// 形式），因此对 modulo_multiply 和 montgomery_multiply 都适用。
+// 使用前需先包含 ch07.h、ch12.h、ch13.h 和 ch13_montgomery.h。
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#define Integer typename
+#define RandomAccessIterator typename
+#define ModularMultiplication typename
+
+template <RandomAccessIterator In, RandomAccessIterator Out, Integer I,
+          ModularMultiplication Op>
+std::size_t batch_multiplicative_inverse(In first, In last, Out out,
+                                         const I& n, Op op) {
+    // precondition: [out, out + (last - first)) is writable
+    //               && (out == first || the two ranges do not overlap)
+    //               && every *first is a residue of op && op multiplies
+    //               modulo n
+    std::ptrdiff_t m = last - first;
+    if (m == 0) return 0;
+    if (static_cast<const void*>(std::addressof(*first))
+        == static_cast<const void*>(std::addressof(*out))) {
+        std::vector<I> copy(first, last);
+        return batch_multiplicative_inverse(copy.begin(), copy.end(), out, n, op);
+    }
+    std::size_t zeros = 0;
+    I c = identity_element(op);
+    for (std::ptrdiff_t i = 0; i < m; ++i) {
+        // invariant: c = first[0] first[1] ... first[i - 1]，跳过 0
+        if (first[i] == I(0)) ++zeros;
+        else c = op(c, first[i]);
+        out[i] = c;
+    }
+    I inverse = to_residue(op, modular_inverse(from_residue(op, c), n));
+    if (inverse == I(0)) {
+        // 总乘积与 n 不互素：逐个求逆
+        std::size_t failures = 0;
+        for (std::ptrdiff_t i = 0; i < m; ++i) {
+            out[i] = to_residue(op, modular_inverse(from_residue(op, first[i]),
+                                                    n));
+            if (out[i] == I(0)) ++failures;
+        }
+        return failures;
+    }
+    for (std::ptrdiff_t i = m - 1; i > 0; --i) {
+        // invariant: inverse = (first[0] ... first[i])^(-1)，跳过 0
+        if (first[i] == I(0)) {
+            out[i] = I(0);
+            continue;
+        }
+        out[i] = op(inverse, out[i - 1]);
+        inverse = op(inverse, first[i]);
+    }
+    out[0] = first[0] == I(0) ? I(0) : inverse;
+    return zeros;
+}
+
+template <RandomAccessIterator In, RandomAccessIterator Out, Integer I>
+std::size_t batch_multiplicative_inverse(In first, In last, Out out,
+                                         const I& n) {
+    // precondition: 0 <= *first < n for every element
+    return batch_multiplicative_inverse(first, last, out, n,
+                                        modulo_multiply<I>(n));
+}
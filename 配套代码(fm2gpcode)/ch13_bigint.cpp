@@ -0,0 +1,154 @@
+// -------------------------------------------------------------------
+// ch13_bigint.cpp -- For testing ch13_bigint.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_bigint.h"
+
+typedef unsigned __int128 U128;
+
+bigint random_bigint(std::mt19937_64& random, std::size_t limbs) {
+  std::vector<limb> v(limbs);
+  for (limb& x : v) x = random();
+  return bigint::from_limbs(v.data(), v.size(), random() & 1);
+}
+
+int main() {
+  std::mt19937_64 random(2015);
+
+  // 小数值：与 __int128 的运算逐一对照
+  bool same = true;
+  for (int i = 0; i < 200000; ++i) {
+    __int128 a = (__int128)(std::int64_t)random() << (i % 60);
+    __int128 b = (std::int64_t)random() >> (i % 64);
+    if (b == 0) b = 7;
+    int k = i % 100;
+    bigint x = a, y = b;
+    if (x + y != bigint(a + b) || x - y != bigint(a - b)
+        || (x >> 62) * y != bigint((a >> 62) * b) || x / y != bigint(a / b)
+        || x % y != bigint(a % b) || (x >> k) != bigint(a >> k)
+        || (x & y) != bigint(a & b) || (x < y) != (a < b)
+        || odd(x) != bool(a & 1) || __int128(x) != a) {
+      same = false;
+    }
+    if (k < 60 && (y << k) != bigint(b * (__int128(1) << k))) same = false;
+  }
+  std::cout << "bigint agrees with __int128 on small values: " << same
+            << std::endl;
+
+  // 大数值：除法恒等式和乘法的几种算法
+  same = true;
+  for (std::size_t n : {1, 2, 3, 5, 17, 31, 32, 33, 70, 100, 257, 800, 2100}) {
+    for (int t = 0; t < 4; ++t) {
+      bigint a = random_bigint(random, n + t * 7);
+      bigint b = random_bigint(random, n);
+      bigint c = random_bigint(random, (n + 1) / 2 + t);
+      bigint p = a * b;
+      std::vector<limb> r(a.size() + b.size());
+      limb_mul_basecase(r.data(), a.limbs(), a.size(), b.limbs(), b.size());
+      if (abs(p) != bigint::from_limbs(r.data(), r.size())) same = false;
+      std::pair<bigint, bigint> qr = quotient_remainder(p + c, b);
+      if (qr.first * b + qr.second != p + c) same = false;
+      if (abs(qr.second) >= abs(b)) same = false;
+      if (p / b != a || p % b != 0) same = false;
+      if ((a + b) - b != a || ((a << 200) >> 200) != a) same = false;
+    }
+  }
+  std::cout << "division identity and multiplication algorithms agree: "
+            << same << std::endl;
+
+  // 递归除法与算法 D 对照；极端的 limb（全 0、全 1）最容易触发修正分支
+  same = true;
+  auto extreme_limb = [&random](int pattern) -> limb {
+    switch (pattern) {
+      case 0: return random();
+      case 1: return random() % 3 == 0 ? 0 : ~limb(0);
+      default: return random() % 2 == 0 ? ~limb(0) : random();
+    }
+  };
+  for (std::size_t bn : {2, 47, 48, 96, 150, 300}) {
+    for (std::size_t an : {bn, bn + 1, bn + 60, 2 * bn, 3 * bn + 50}) {
+      for (int pattern = 0; pattern < 3; ++pattern) {
+        std::vector<limb> a(an), b(bn);
+        for (limb& x : a) x = extreme_limb(pattern);
+        for (limb& x : b) x = extreme_limb(pattern);
+        if (b.back() == 0) b.back() = 1;
+        std::vector<limb> q1(an - bn + 1), r1(bn), q2(an - bn + 1);
+        limb_divrem(q1.data(), r1.data(), a.data(), an, b.data(), bn);
+        // 直接调用算法 D
+        int s = std::countl_zero(b.back());
+        std::vector<limb> v(bn), u(an + 1);
+        limb_shift_left(v.data(), b.data(), bn, s);
+        u[an] = limb_shift_left(u.data(), a.data(), an, s);
+        limb_divrem_basecase(q2.data(), u.data(), an + 1, v.data(), bn,
+                             limb_reciprocal(v[bn - 1], v[bn - 2]));
+        limb_shift_right(u.data(), u.data(), bn, s);
+        if (q1 != q2 || !std::equal(r1.begin(), r1.end(), u.begin())) {
+          same = false;
+        }
+        bigint x = bigint::from_limbs(a.data(), an);
+        bigint y = bigint::from_limbs(b.data(), bn);
+        bigint_divisor divisor(-y);
+        if (quotient_remainder(-x, divisor) != quotient_remainder(-x, -y)
+            || remainder(x, divisor) != x % y) {
+          same = false;
+        }
+      }
+    }
+  }
+  std::cout << "recursive division, algorithm D and bigint_divisor agree: "
+            << same << std::endl;
+
+  bigint f = 1;
+  for (int i = 2; i <= 30; ++i) f *= i;
+  std::cout << "30! = " << f << std::endl;
+  std::cout << "bigint(\"-0x123456789abcdef0123456789\") = "
+            << bigint("-0x123456789abcdef0123456789") << std::endl;
+
+  // ch07 与 ch12 的模板直接实例化
+  bigint m127 = power_monoid(bigint(2), 127) - 1;
+  std::cout << "2^127 - 1 = " << m127 << std::endl;
+  bigint x("123456789012345678901234567890123456789");
+  bigint y("987654321098765432109876543210987654321");
+  std::cout << "gcd(x * 12, y * 18) = " << gcd(x * 12, y * 18)
+            << ", stein_gcd = " << stein_gcd(x * 12, y * 18) << std::endl;
+  std::pair<bigint, bigint> e = extended_gcd(x, m127);
+  std::cout << "extended_gcd(x, 2^127 - 1): (x * coefficient - gcd) mod (2^127 - 1) = "
+            << (x * e.first - e.second) % m127 << ", gcd = " << e.second
+            << std::endl;
+
+  // ch13：米勒-拉宾与 RSA
+  bigint m521 = power_monoid(bigint(2), 521) - 1;
+  bigint q = m521 - 1;
+  bigint k = 0;
+  while (even(q)) {
+    q = half(q);
+    ++k;
+  }
+  std::cout << "miller_rabin_test(2^521 - 1, 3) = "
+            << miller_rabin_test(m521, q, k, bigint(3)) << std::endl;
+  std::cout << "fermat_test(2^521 + 1, 3) = "
+            << fermat_test(m521 + 2, bigint(3)) << std::endl;
+
+  bigint p1 = m521;
+  bigint p2 = power_monoid(bigint(2), 607) - 1;
+  bigint n = p1 * p2;
+  bigint phi = (p1 - 1) * (p2 - 1);
+  bigint d = multiplicative_inverse(bigint(65537), phi);
+  bigint message("31415926535897932384626433832795028841971693993751");
+  bigint cipher = power_semigroup(message, bigint(65537),
+                                  modulo_multiply<bigint>(n));
+  bigint plain = power_semigroup(cipher, d, modulo_multiply<bigint>(n));
+  std::cout << "RSA with (2^521 - 1)(2^607 - 1): decrypt(encrypt(m)) == m: "
+            << (plain == message) << std::endl;
+  std::cout << "same with reciprocal_multiply: "
+            << (power_semigroup(cipher, d, reciprocal_multiply(n)) == message)
+            << std::endl;
+}
@@ -0,0 +1,1061 @@
+// -------------------------------------------------------------------
+// ch13_bigint.h -- Arbitrary-precision integers that model Integer and
+// EuclideanDomain (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// bigint 是符号-绝对值表示的任意精度整数，绝对值存为 64 位 limb 的
+// 小端数组。不超过 128 位的值直接存放在对象内部，不分配堆内存。
+// 运算语义与内置整数相同：除法向零截断，余数与被除数同号，>> 是算术
+// 右移（向负无穷取整），& 按补码计算。再加上 odd、half、
+// quotient_remainder 等重载，ch07.h 的 power_monoid、ch12.h 的 gcd、
+// extended_gcd、stein_gcd 和 ch13.h 的 miller_rabin_test、
+// multiplicative_inverse 都可以不加修改地实例化。
+//
+// 乘法按规模选择算法：小于 karatsuba_threshold 个 limb 用教科书方法，
+// 之上用 Karatsuba，两个因子都不小于 toom3_threshold 时用 Toom-3。
+// 除法不再像 ch04.h 的 quotient_remainder 那样每次求一位商，而是每次
+// 求一个 limb：较小的除数用 Knuth 的算法 D，试商用预计算的倒数代替硬件
+// 除法；除数和商都不小于 divide_recursive_threshold 个 limb 时用
+// Burnikel-Ziegler 递归除法，把大部分工作交给 Karatsuba 乘法。
+// 反复除以同一个数（例如 power_semigroup 中的模约简）时，bigint_divisor
+// 把规范化的除数和倒数保存下来，reciprocal_multiply 是用它做约简的
+// 模乘运算。
+//
+// 底层的 limb_* 函数直接作用于 limb 数组（与 GMP 的 mpn 层类似），
+// bigint 负责内存与符号。
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+typedef std::uint64_t limb;
+typedef unsigned __int128 double_limb;
+
+const int limb_bits = 64;
+
+// 低于这个 limb 数用教科书乘法，否则用 Karatsuba
+const std::size_t karatsuba_threshold = 32;
+
+// 两个因子都不小于这个 limb 数时用 Toom-3
+const std::size_t toom3_threshold = 2048;
+
+// ---- limb 数组上的无符号运算 ----
+
+// r = a + b，a 和 b 都有 n 个 limb，返回进位；r 可以与 a 或 b 重合
+inline limb limb_add_n(limb* r, const limb* a, const limb* b, std::size_t n) {
+    limb carry = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double_limb s = double_limb(a[i]) + b[i] + carry;
+        r[i] = limb(s);
+        carry = limb(s >> limb_bits);
+    }
+    return carry;
+}
+
+// r = a + b，an >= bn，r 有 an 个 limb，返回进位
+inline limb limb_add(limb* r, const limb* a, std::size_t an,
+                     const limb* b, std::size_t bn) {
+    limb carry = limb_add_n(r, a, b, bn);
+    for (std::size_t i = bn; i < an; ++i) {
+        r[i] = a[i] + carry;
+        carry = r[i] < carry;
+    }
+    return carry;
+}
+
+// r = a - b，a 和 b 都有 n 个 limb，返回借位
+inline limb limb_sub_n(limb* r, const limb* a, const limb* b, std::size_t n) {
+    limb borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        limb x = a[i];
+        limb y = b[i] + borrow;
+        borrow = (y < borrow) | (x < y);
+        r[i] = x - y;
+    }
+    return borrow;
+}
+
+// r = a - b，an >= bn，r 有 an 个 limb，返回借位
+inline limb limb_sub(limb* r, const limb* a, std::size_t an,
+                     const limb* b, std::size_t bn) {
+    limb borrow = limb_sub_n(r, a, b, bn);
+    for (std::size_t i = bn; i < an; ++i) {
+        limb x = a[i];
+        r[i] = x - borrow;
+        borrow = x < borrow;
+    }
+    return borrow;
+}
+
+// r = a * b，r 有 n 个 limb，返回最高的一个 limb
+inline limb limb_mul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    limb carry = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double_limb p = double_limb(a[i]) * b + carry;
+        r[i] = limb(p);
+        carry = limb(p >> limb_bits);
+    }
+    return carry;
+}
+
+// r += a * b，r 有 n 个 limb，返回进位
+inline limb limb_addmul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    limb carry = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double_limb p = double_limb(a[i]) * b + r[i] + carry;
+        r[i] = limb(p);
+        carry = limb(p >> limb_bits);
+    }
+    return carry;
+}
+
+// r -= a * b，r 有 n 个 limb，返回借位
+inline limb limb_submul_1(limb* r, const limb* a, std::size_t n, limb b) {
+    limb borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double_limb p = double_limb(a[i]) * b + borrow;
+        limb lo = limb(p);
+        borrow = limb(p >> limb_bits) + (r[i] < lo);
+        r[i] -= lo;
+    }
+    return borrow;
+}
+
+// r = a * b（教科书方法），r 有 an + bn 个 limb，不能与 a、b 重合
+inline void limb_mul_basecase(limb* r, const limb* a, std::size_t an,
+                              const limb* b, std::size_t bn) {
+    r[an] = limb_mul_1(r, a, an, b[0]);
+    for (std::size_t j = 1; j < bn; ++j) {
+        r[an + j] = limb_addmul_1(r + j, a, an, b[j]);
+    }
+}
+
+// r = a * b，an >= bn >= 1，r 有 an + bn 个 limb，不能与 a、b 重合
+inline void limb_mul(limb* r, const limb* a, std::size_t an,
+                     const limb* b, std::size_t bn) {
+    if (bn < karatsuba_threshold) {
+        limb_mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    std::size_t h = (an + 1) / 2;
+    if (bn <= h) {
+        // 长短悬殊：把 a 切成 bn 个 limb 一段，逐段与 b 相乘再错位相加
+        std::fill(r, r + an + bn, limb(0));
+        std::vector<limb> t(2 * bn);
+        for (std::size_t i = 0; i < an; i += bn) {
+            std::size_t m = std::min(bn, an - i);
+            limb_mul(t.data(), b, bn, a + i, m);
+            limb_add(r + i, r + i, an + bn - i, t.data(), m + bn);
+        }
+        return;
+    }
+    // Karatsuba：a = a1 B^h + a0，b = b1 B^h + b0，
+    // ab = z2 B^2h + ((a0 + a1)(b0 + b1) - z0 - z2) B^h + z0
+    const limb* a0 = a;
+    const limb* a1 = a + h;
+    const limb* b0 = b;
+    const limb* b1 = b + h;
+    std::size_t an1 = an - h;
+    std::size_t bn1 = bn - h;
+    limb_mul(r, a0, h, b0, h);                // z0 -> r[0, 2h)
+    limb_mul(r + 2 * h, a1, an1, b1, bn1);    // z2 -> r[2h, an + bn)
+
+    std::vector<limb> sa(h + 1), sb(h + 1), z1(2 * h + 2);
+    sa[h] = limb_add(sa.data(), a0, h, a1, an1);
+    sb[h] = limb_add(sb.data(), b0, h, b1, bn1);
+    limb_mul(z1.data(), sa.data(), h + 1, sb.data(), h + 1);
+    limb_sub(z1.data(), z1.data(), 2 * h + 2, r, 2 * h);
+    limb_sub(z1.data(), z1.data(), 2 * h + 2, r + 2 * h, an1 + bn1);
+    // z1 = a0 b1 + a1 b0 放得进 r[h, an + bn)，多出的高位必为 0
+    std::size_t n1 = std::min(2 * h + 2, an + bn - h);
+    limb_add(r + h, r + h, an + bn - h, z1.data(), n1);
+}
+
+// ---- 除法 ----
+//
+// 试商用 Möller 和 Granlund 的预计算倒数（"Improved division by
+// invariant integers", 2011）代替 128 位除以 64 位的硬件除法：对最高位
+// 为 1 的除数 d，v = floor((B^2 - 1) / d) - B 只算一次，此后每个商 limb
+// 只需两次乘法和几次比较。
+
+// a 和 b 的 n 个 limb 比较大小
+inline int limb_compare(const limb* a, const limb* b, std::size_t n) {
+    for (std::size_t i = n; i-- != 0; ) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// r = a << s，0 <= s < limb_bits，返回移出的高位；r 可以与 a 重合
+inline limb limb_shift_left(limb* r, const limb* a, std::size_t n, int s) {
+    if (s == 0) {
+        std::copy(a, a + n, r);
+        return 0;
+    }
+    limb high = a[n - 1] >> (limb_bits - s);
+    for (std::size_t i = n - 1; i > 0; --i) {
+        r[i] = (a[i] << s) | (a[i - 1] >> (limb_bits - s));
+    }
+    r[0] = a[0] << s;
+    return high;
+}
+
+// r = a >> s，0 <= s < limb_bits；r 可以与 a 重合
+inline void limb_shift_right(limb* r, const limb* a, std::size_t n, int s) {
+    if (s == 0) {
+        std::copy(a, a + n, r);
+        return;
+    }
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        r[i] = (a[i] >> s) | (a[i + 1] << (limb_bits - s));
+    }
+    r[n - 1] = a[n - 1] >> s;
+}
+
+// 单个 limb 除数的倒数
+inline limb limb_reciprocal(limb d) {
+    // precondition: d 的最高位为 1
+    return limb(~double_limb(0) / d);
+}
+
+// 两个 limb 除数 (d1, d0) 的倒数 floor((B^3 - 1) / (d1 B + d0)) - B
+inline limb limb_reciprocal(limb d1, limb d0) {
+    // precondition: d1 的最高位为 1
+    limb v = limb_reciprocal(d1);
+    limb p = d1 * v + d0;
+    if (p < d0) {
+        --v;
+        if (p >= d1) {
+            --v;
+            p -= d1;
+        }
+        p -= d1;
+    }
+    double_limb t = double_limb(v) * d0;
+    limb t1 = limb(t >> limb_bits);
+    limb t0 = limb(t);
+    p += t1;
+    if (p < t1) {
+        --v;
+        if (p > d1 || (p == d1 && t0 >= d0)) --v;
+    }
+    return v;
+}
+
+// (u1 B + u0) / d，余数写入 r
+inline limb limb_div_2by1(limb& r, limb u1, limb u0, limb d, limb v) {
+    // precondition: d 的最高位为 1 && u1 < d && v == limb_reciprocal(d)
+    double_limb q = double_limb(v) * u1
+                    + ((double_limb(u1) << limb_bits) | u0);
+    limb q1 = limb(q >> limb_bits) + 1;
+    limb q0 = limb(q);
+    r = u0 - q1 * d;
+    if (r > q0) {
+        --q1;
+        r += d;
+    }
+    if (r >= d) {
+        ++q1;
+        r -= d;
+    }
+    return q1;
+}
+
+// (u2 B^2 + u1 B + u0) / (d1 B + d0)，余数写入 (r1, r0)
+inline limb limb_div_3by2(limb& r1, limb& r0, limb u2, limb u1, limb u0,
+                          limb d1, limb d0, limb v) {
+    // precondition: d1 的最高位为 1 && (u2, u1) < (d1, d0)
+    //               && v == limb_reciprocal(d1, d0)
+    const double_limb d = (double_limb(d1) << limb_bits) | d0;
+    double_limb q = double_limb(v) * u2
+                    + ((double_limb(u2) << limb_bits) | u1);
+    limb q1 = limb(q >> limb_bits);
+    limb q0 = limb(q);
+    r1 = u1 - q1 * d1;
+    double_limb r = ((double_limb(r1) << limb_bits) | u0)
+                    - double_limb(d0) * q1 - d;
+    ++q1;
+    if (limb(r >> limb_bits) >= q0) {
+        --q1;
+        r += d;
+    }
+    if (r >= d) {
+        ++q1;
+        r -= d;
+    }
+    r1 = limb(r >> limb_bits);
+    r0 = limb(r);
+    return q1;
+}
+
+// q = a / d，q 有 n 个 limb，返回余数；q 可以与 a 重合
+inline limb limb_divrem_1(limb* q, const limb* a, std::size_t n, limb d) {
+    // 把 d 左移到最高位为 1，被除数随之左移，余数最后移回
+    int s = std::countl_zero(d);
+    d <<= s;
+    limb v = limb_reciprocal(d);
+    limb r = s == 0 ? 0 : a[n - 1] >> (limb_bits - s);
+    for (std::size_t i = n; i-- != 0; ) {
+        limb u = a[i] << s;
+        if (s != 0 && i != 0) u |= a[i - 1] >> (limb_bits - s);
+        q[i] = limb_div_2by1(r, r, u, d, v);
+    }
+    return r >> s;
+}
+
+// 低于这个 limb 数用 Knuth 的算法 D，否则用 Burnikel-Ziegler 递归除法
+const std::size_t divide_recursive_threshold = 48;
+
+// Knuth 算法 D：u 的 un 个 limb 除以规范化的 v（n 个 limb），商的低
+// un - n 个 limb 写入 q，余数留在 u[0, n)。若 u 的最高 n 个 limb 不小于
+// v，先减去一次 v，返回商的最高位 1；否则返回 0。
+// precondition: un >= n >= 2 && v[n - 1] 的最高位为 1
+//               && inverse == limb_reciprocal(v[n - 1], v[n - 2])
+inline limb limb_divrem_basecase(limb* q, limb* u, std::size_t un,
+                                 const limb* v, std::size_t n, limb inverse) {
+    limb qh = limb_compare(u + un - n, v, n) >= 0;
+    if (qh) limb_sub_n(u + un - n, u + un - n, v, n);
+    limb d1 = v[n - 1];
+    limb d0 = v[n - 2];
+    for (std::size_t j = un - n; j-- != 0; ) {
+        // invariant: u[j + 1, j + n + 1) < v，所以试商不超过一个 limb
+        limb u2 = u[j + n];
+        limb u1 = u[j + n - 1];
+        limb qhat;
+        if (u2 == d1 && u1 == d0) {
+            // 此时真商恰为 B - 1
+            qhat = ~limb(0);
+            u[j + n] -= limb_submul_1(u + j, v, n, qhat);
+        } else {
+            // 最高三个 limb 除以 (d1, d0) 的试商至多比真商大 1
+            limb r1, r0;
+            qhat = limb_div_3by2(r1, r0, u2, u1, u[j + n - 2], d1, d0, inverse);
+            limb borrow = limb_submul_1(u + j, v, n - 2, qhat);
+            limb b0 = r0 < borrow;
+            r0 -= borrow;
+            limb b1 = r1 < b0;
+            r1 -= b0;
+            u[j + n - 2] = r0;
+            u[j + n - 1] = r1;
+            u[j + n] = 0;
+            if (b1) {
+                // 试商大了 1：加回一个除数，进位与借位相抵
+                --qhat;
+                limb_add_n(u + j, u + j, v, n);
+            }
+        }
+        q[j] = qhat;
+    }
+    return qh;
+}
+
+// Burnikel-Ziegler 递归除法中的一步：窗口 w 有 n + k 个 limb（k <= n），
+// 除以规范化的 v（n 个 limb），商的低 k 个 limb 写入 q，余数留在
+// w[0, n)，返回值同 limb_divrem_basecase。t 是 n 个 limb 的工作区。
+//   k == n：商分高低两半，各是一个 k < n 的子问题；
+//   k < n：先用 v 的最高 k 个 limb 去除 w 的最高 2k 个 limb（k == k 的
+//          子问题）估计商，再减去商乘 v 的低 n - k 个 limb，至多修正两次。
+// 乘法是 Karatsuba 时，总代价与一次 n x n 乘法的常数倍相当。
+inline limb limb_divrem_block(limb* q, limb* w, std::size_t k,
+                              const limb* v, std::size_t n, limb inverse,
+                              limb* t) {
+    if (k < divide_recursive_threshold) {
+        return limb_divrem_basecase(q, w, n + k, v, n, inverse);
+    }
+    if (k == n) {
+        std::size_t lo = n / 2;
+        std::size_t hi = n - lo;
+        limb qh = limb_divrem_block(q + lo, w + lo, hi, v, n, inverse, t);
+        limb_divrem_block(q, w, lo, v, n, inverse, t);  // 最高 n 个 limb 已小于 v
+        return qh;
+    }
+    std::size_t m = n - k;
+    limb qh = limb_divrem_block(q, w + m, k, v + m, k, inverse, t);
+    if (k >= m) limb_mul(t, q, k, v, m);
+    else        limb_mul(t, v, m, q, k);
+    limb borrow = limb_sub_n(w, w, t, n);
+    if (qh) borrow += limb_sub_n(w + k, w + k, v, m);
+    const limb one = 1;
+    while (borrow != 0) {
+        qh -= limb_sub(q, q, k, &one, 1);
+        borrow -= limb_add_n(w, w, v, n);
+    }
+    return qh;
+}
+
+// u 的 un 个 limb 除以规范化的 v（n 个 limb），商的 un - n 个 limb 写入 q，
+// 余数留在 u[0, n)。从高到低每次求 n 个商 limb（最高一块可能更短）。
+// precondition: un >= n >= 2 && v[n - 1] 的最高位为 1
+//               && u 的最高 n 个 limb 小于 v
+//               && inverse == limb_reciprocal(v[n - 1], v[n - 2])
+inline void limb_divrem_normalized(limb* q, limb* u, std::size_t un,
+                                   const limb* v, std::size_t n,
+                                   limb inverse) {
+    std::size_t qn = un - n;
+    if (qn < divide_recursive_threshold || n < divide_recursive_threshold) {
+        limb_divrem_basecase(q, u, un, v, n, inverse);
+        return;
+    }
+    std::vector<limb> t(n);
+    std::size_t k = qn % n == 0 ? n : qn % n;
+    for (std::size_t j = qn - k; ; j -= n) {
+        limb_divrem_block(q + j, u + j, k, v, n, inverse, t.data());
+        if (j == 0) break;
+        k = n;
+    }
+}
+
+// q = a / b，r = a % b
+// precondition: an >= bn >= 2 && b[bn - 1] != 0
+//               q 有 an - bn + 1 个 limb，r 有 bn 个 limb
+inline void limb_divrem(limb* q, limb* r, const limb* a, std::size_t an,
+                        const limb* b, std::size_t bn) {
+    // 规范化：左移使除数的最高位为 1；被除数多出一个 limb
+    int s = std::countl_zero(b[bn - 1]);
+    std::vector<limb> v(bn), u(an + 1);
+    limb_shift_left(v.data(), b, bn, s);
+    u[an] = limb_shift_left(u.data(), a, an, s);
+    limb_divrem_normalized(q, u.data(), an + 1, v.data(), bn,
+                           limb_reciprocal(v[bn - 1], v[bn - 2]));
+    // 余数右移回去
+    limb_shift_right(r, u.data(), bn, s);
+}
+
+// ---- limb_vector：小对象优化的 limb 数组 ----
+
+class limb_vector {
+    static const std::uint32_t inline_capacity = 2;  // 128 位以内不分配内存
+    std::uint32_t n = 0;
+    std::uint32_t capacity = inline_capacity;
+    union {
+        limb local[inline_capacity];
+        limb* heap;
+    };
+
+    void release() {
+        if (capacity > inline_capacity) delete[] heap;
+        capacity = inline_capacity;
+        n = 0;
+    }
+
+    void take(limb_vector& x) {
+        // precondition: *this 没有堆内存
+        n = x.n;
+        capacity = x.capacity;
+        if (capacity > inline_capacity) {
+            heap = x.heap;
+        } else {
+            std::copy(x.local, x.local + n, local);
+        }
+        x.capacity = inline_capacity;
+        x.n = 0;
+    }
+
+public:
+    limb_vector() {}
+
+    limb_vector(const limb_vector& x) {
+        reserve(x.n);
+        std::copy(x.data(), x.data() + x.n, data());
+        n = x.n;
+    }
+
+    limb_vector(limb_vector&& x) noexcept { take(x); }
+
+    limb_vector& operator=(const limb_vector& x) {
+        if (this != &x) {
+            n = 0;
+            reserve(x.n);
+            std::copy(x.data(), x.data() + x.n, data());
+            n = x.n;
+        }
+        return *this;
+    }
+
+    limb_vector& operator=(limb_vector&& x) noexcept {
+        if (this != &x) {
+            release();
+            take(x);
+        }
+        return *this;
+    }
+
+    ~limb_vector() { release(); }
+
+    limb* data() { return capacity > inline_capacity ? heap : local; }
+    const limb* data() const {
+        return capacity > inline_capacity ? heap : local;
+    }
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    limb& operator[](std::size_t i) { return data()[i]; }
+    const limb& operator[](std::size_t i) const { return data()[i]; }
+    limb back() const { return data()[n - 1]; }
+
+    void reserve(std::size_t m) {
+        if (m <= capacity) return;
+        std::size_t c = std::max(m, std::size_t(capacity) * 2);
+        limb* p = new limb[c];
+        std::copy(data(), data() + n, p);
+        std::uint32_t size = n;
+        release();
+        heap = p;
+        capacity = std::uint32_t(c);
+        n = size;
+    }
+
+    void resize(std::size_t m) {
+        // 新增的 limb 为 0
+        reserve(m);
+        if (m > n) std::fill(data() + n, data() + m, limb(0));
+        n = std::uint32_t(m);
+    }
+
+    void push_back(limb x) {
+        reserve(n + 1);
+        data()[n++] = x;
+    }
+
+    void trim() {
+        // 去掉高位的 0 limb
+        const limb* p = data();
+        while (n > 0 && p[n - 1] == 0) --n;
+    }
+};
+
+// ---- bigint ----
+
+template <typename T>
+constexpr bool is_builtin_integer =
+    std::is_integral_v<T> || std::is_same_v<T, __int128>
+    || std::is_same_v<T, unsigned __int128>;
+
+class bigint {
+    limb_vector mag;        // invariant: mag 没有高位的 0 limb
+    bool negative = false;  // invariant: 0 没有负号
+
+    void normalize() {
+        mag.trim();
+        if (mag.empty()) negative = false;
+    }
+
+    static int compare_magnitude(const bigint& x, const bigint& y) {
+        if (x.mag.size() != y.mag.size()) {
+            return x.mag.size() < y.mag.size() ? -1 : 1;
+        }
+        for (std::size_t i = x.mag.size(); i-- != 0; ) {
+            if (x.mag[i] != y.mag[i]) return x.mag[i] < y.mag[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // |x| + |y|
+    static limb_vector add_magnitudes(const bigint& x, const bigint& y) {
+        const limb_vector& a = x.mag.size() >= y.mag.size() ? x.mag : y.mag;
+        const limb_vector& b = x.mag.size() >= y.mag.size() ? y.mag : x.mag;
+        limb_vector r;
+        r.resize(a.size() + 1);
+        r[a.size()] = limb_add(r.data(), a.data(), a.size(), b.data(), b.size());
+        r.trim();
+        return r;
+    }
+
+    // |x| - |y|
+    // precondition: |x| >= |y|
+    static limb_vector subtract_magnitudes(const bigint& x, const bigint& y) {
+        limb_vector r;
+        r.resize(x.mag.size());
+        limb_sub(r.data(), x.mag.data(), x.mag.size(), y.mag.data(),
+                 y.mag.size());
+        r.trim();
+        return r;
+    }
+
+    // x + (-1)^subtract y
+    void add(const bigint& y, bool subtract) {
+        bool y_negative = y.negative != subtract;
+        if (negative == y_negative) {
+            mag = add_magnitudes(*this, y);
+        } else if (compare_magnitude(*this, y) >= 0) {
+            mag = subtract_magnitudes(*this, y);
+        } else {
+            mag = subtract_magnitudes(y, *this);
+            negative = y_negative;
+        }
+        normalize();
+    }
+
+    static limb_vector multiply_magnitudes(const limb* a, std::size_t an,
+                                           const limb* b, std::size_t bn);
+
+    static limb_vector toom3_multiply(const limb* a, std::size_t an,
+                                      const limb* b, std::size_t bn);
+
+    // *this = *this * m + a（作用于绝对值），用于解析字符串
+    void multiply_add(limb m, limb a) {
+        limb carry = limb_mul_1(mag.data(), mag.data(), mag.size(), m);
+        for (std::size_t i = 0; i < mag.size() && a != 0; ++i) {
+            mag[i] += a;
+            a = mag[i] < a;
+        }
+        carry += a;  // carry < m，加 1 不会溢出
+        if (carry != 0) mag.push_back(carry);
+    }
+
+    // 绝对值除以单个 limb，返回余数
+    limb divide_by_limb(limb d) {
+        limb r = limb_divrem_1(mag.data(), mag.data(), mag.size(), d);
+        normalize();
+        return r;
+    }
+
+public:
+    bigint() {}
+
+    template <typename T,
+              typename = std::enable_if_t<is_builtin_integer<T>>>
+    bigint(T x) {
+        unsigned __int128 m = (unsigned __int128)x;
+        if constexpr (std::is_signed_v<T> || std::is_same_v<T, __int128>) {
+            if (x < 0) {
+                m = ~m + 1;  // 补码取负即绝对值
+                negative = true;
+            }
+        }
+        mag.push_back(limb(m));
+        mag.push_back(limb(m >> limb_bits));
+        normalize();
+    }
+
+    explicit bigint(const std::string& s) {
+        // 十进制，或以 0x 开头的十六进制，前面可以有负号
+        std::size_t i = 0;
+        bool minus = false;
+        if (i < s.size() && (s[i] == '-' || s[i] == '+')) minus = s[i++] == '-';
+        int base = 10;
+        if (s.size() - i > 2 && s[i] == '0' && (s[i + 1] == 'x' || s[i + 1] == 'X')) {
+            base = 16;
+            i += 2;
+        }
+        if (i == s.size()) throw std::invalid_argument("bigint: empty number");
+        for (; i < s.size(); ++i) {
+            int d;
+            char c = s[i];
+            if ('0' <= c && c <= '9') d = c - '0';
+            else if ('a' <= c && c <= 'f') d = c - 'a' + 10;
+            else if ('A' <= c && c <= 'F') d = c - 'A' + 10;
+            else d = base;
+            if (d >= base) throw std::invalid_argument("bigint: bad digit in " + s);
+            multiply_add(limb(base), limb(d));
+        }
+        negative = minus;
+        normalize();
+    }
+
+    explicit bigint(const char* s) : bigint(std::string(s)) {}
+
+    // 由 n 个 limb 的绝对值构造
+    static bigint from_limbs(const limb* p, std::size_t n,
+                             bool negative = false) {
+        bigint x;
+        x.mag.resize(n);
+        std::copy(p, p + n, x.mag.data());
+        x.negative = negative;
+        x.normalize();
+        return x;
+    }
+
+    std::size_t size() const { return mag.size(); }
+    const limb* limbs() const { return mag.data(); }
+    bool is_negative() const { return negative; }
+
+    // 绝对值的位数；0 的位数为 0
+    int bit_length() const {
+        if (mag.empty()) return 0;
+        return int(mag.size() * limb_bits) - std::countl_zero(mag.back());
+    }
+
+    explicit operator bool() const { return !mag.empty(); }
+
+    template <typename T,
+              typename = std::enable_if_t<is_builtin_integer<T>>>
+    explicit operator T() const {
+        // 与内置整数的转换相同：取补码的低位
+        unsigned __int128 m = 0;
+        if (mag.size() > 0) m = mag[0];
+        if (mag.size() > 1) m |= (unsigned __int128)mag[1] << limb_bits;
+        if (negative) m = ~m + 1;
+        return T(m);
+    }
+
+    // ---- 比较 ----
+
+    friend bool operator==(const bigint& x, const bigint& y) {
+        return x.negative == y.negative && compare_magnitude(x, y) == 0;
+    }
+    friend bool operator!=(const bigint& x, const bigint& y) {
+        return !(x == y);
+    }
+    friend bool operator<(const bigint& x, const bigint& y) {
+        if (x.negative != y.negative) return x.negative;
+        int c = compare_magnitude(x, y);
+        return x.negative ? c > 0 : c < 0;
+    }
+    friend bool operator>(const bigint& x, const bigint& y) { return y < x; }
+    friend bool operator<=(const bigint& x, const bigint& y) {
+        return !(y < x);
+    }
+    friend bool operator>=(const bigint& x, const bigint& y) {
+        return !(x < y);
+    }
+
+    // ---- 加减乘 ----
+
+    bigint operator-() const {
+        bigint x = *this;
+        if (!x.mag.empty()) x.negative = !x.negative;
+        return x;
+    }
+
+    bigint& operator+=(const bigint& y) {
+        add(y, false);
+        return *this;
+    }
+    bigint& operator-=(const bigint& y) {
+        add(y, true);
+        return *this;
+    }
+    bigint& operator++() { return *this += bigint(1); }
+    bigint& operator--() { return *this -= bigint(1); }
+    bigint operator++(int) { bigint t = *this; ++*this; return t; }
+    bigint operator--(int) { bigint t = *this; --*this; return t; }
+
+    friend bigint operator+(bigint x, const bigint& y) { return x += y; }
+    friend bigint operator-(bigint x, const bigint& y) { return x -= y; }
+
+    friend bigint operator*(const bigint& x, const bigint& y) {
+        bigint z;
+        if (x.mag.empty() || y.mag.empty()) return z;
+        z.mag = multiply_magnitudes(x.mag.data(), x.mag.size(),
+                                    y.mag.data(), y.mag.size());
+        z.negative = x.negative != y.negative;
+        z.normalize();
+        return z;
+    }
+    bigint& operator*=(const bigint& y) { return *this = *this * y; }
+
+    // ---- 除法：向零截断 ----
+
+    friend std::pair<bigint, bigint>
+    quotient_remainder(const bigint& x, const bigint& y) {
+        if (y.mag.empty()) throw std::domain_error("bigint: division by zero");
+        std::pair<bigint, bigint> qr;
+        bigint& q = qr.first;
+        bigint& r = qr.second;
+        if (compare_magnitude(x, y) < 0) {
+            r = x;
+            return qr;
+        }
+        std::size_t an = x.mag.size();
+        std::size_t bn = y.mag.size();
+        q.mag.resize(an - bn + 1);
+        if (bn == 1) {
+            r.mag.resize(1);
+            r.mag[0] = limb_divrem_1(q.mag.data(), x.mag.data(), an, y.mag[0]);
+        } else {
+            r.mag.resize(bn);
+            limb_divrem(q.mag.data(), r.mag.data(), x.mag.data(), an,
+                        y.mag.data(), bn);
+        }
+        q.negative = x.negative != y.negative;
+        r.negative = x.negative;
+        q.normalize();
+        r.normalize();
+        return qr;
+    }
+
+    friend bigint operator/(const bigint& x, const bigint& y) {
+        return quotient_remainder(x, y).first;
+    }
+    friend bigint operator%(const bigint& x, const bigint& y) {
+        return quotient_remainder(x, y).second;
+    }
+    bigint& operator/=(const bigint& y) { return *this = *this / y; }
+    bigint& operator%=(const bigint& y) { return *this = *this % y; }
+
+    // ---- 移位与按位与 ----
+
+    friend bigint operator<<(const bigint& x, std::size_t k) {
+        if (x.mag.empty()) return x;
+        std::size_t words = k / limb_bits;
+        int bits = int(k % limb_bits);
+        bigint z;
+        z.mag.resize(x.mag.size() + words + 1);
+        limb* r = z.mag.data();
+        const limb* a = x.mag.data();
+        std::size_t n = x.mag.size();
+        if (bits == 0) {
+            std::copy(a, a + n, r + words);
+        } else {
+            r[words + n] = a[n - 1] >> (limb_bits - bits);
+            for (std::size_t i = n - 1; i > 0; --i) {
+                r[words + i] = (a[i] << bits) | (a[i - 1] >> (limb_bits - bits));
+            }
+            r[words] = a[0] << bits;
+        }
+        z.negative = x.negative;
+        z.normalize();
+        return z;
+    }
+
+    friend bigint operator>>(const bigint& x, std::size_t k) {
+        // 算术右移：负数向负无穷取整
+        std::size_t words = k / limb_bits;
+        int bits = int(k % limb_bits);
+        std::size_t n = x.mag.size();
+        if (words >= n) return x.negative ? bigint(-1) : bigint();
+        bigint z;
+        z.mag.resize(n - words);
+        limb* r = z.mag.data();
+        const limb* a = x.mag.data() + words;
+        std::size_t m = n - words;
+        if (bits == 0) {
+            std::copy(a, a + m, r);
+        } else {
+            for (std::size_t i = 0; i + 1 < m; ++i) {
+                r[i] = (a[i] >> bits) | (a[i + 1] << (limb_bits - bits));
+            }
+            r[m - 1] = a[m - 1] >> bits;
+        }
+        z.negative = x.negative;
+        z.normalize();
+        if (x.negative) {
+            // 移出的位中有 1 时，绝对值加 1
+            bool inexact = bits != 0 && (x.mag[words] << (limb_bits - bits)) != 0;
+            for (std::size_t i = 0; i < words && !inexact; ++i) {
+                inexact = x.mag[i] != 0;
+            }
+            if (inexact) z -= bigint(1);
+        }
+        return z;
+    }
+
+    bigint& operator<<=(std::size_t k) { return *this = *this << k; }
+    bigint& operator>>=(std::size_t k) { return *this = *this >> k; }
+
+    friend bigint operator&(const bigint& x, const bigint& y) {
+        if (!x.negative && !y.negative) {
+            bigint z;
+            std::size_t n = std::min(x.mag.size(), y.mag.size());
+            z.mag.resize(n);
+            for (std::size_t i = 0; i < n; ++i) z.mag[i] = x.mag[i] & y.mag[i];
+            z.normalize();
+            return z;
+        }
+        // 有负数时按补码计算：-m 的补码是 ~(m - 1)
+        std::size_t n = std::max(x.mag.size(), y.mag.size()) + 1;
+        auto twos_complement = [n](const bigint& v) {
+            std::vector<limb> w(n, 0);
+            std::copy(v.mag.data(), v.mag.data() + v.mag.size(), w.begin());
+            if (v.negative) {
+                limb borrow = 1;
+                for (limb& d : w) {
+                    limb t = d;
+                    d = ~(t - borrow);
+                    borrow = t < borrow;
+                }
+            }
+            return w;
+        };
+        std::vector<limb> a = twos_complement(x);
+        std::vector<limb> b = twos_complement(y);
+        for (std::size_t i = 0; i < n; ++i) a[i] &= b[i];
+        bool sign = (a[n - 1] >> (limb_bits - 1)) != 0;
+        if (sign) {
+            // 结果为负：绝对值 = ~w + 1
+            limb carry = 1;
+            for (limb& d : a) {
+                d = ~d + carry;
+                carry = carry && d == 0;
+            }
+        }
+        return from_limbs(a.data(), n, sign);
+    }
+    bigint& operator&=(const bigint& y) { return *this = *this & y; }
+
+    // ---- 文本 ----
+
+    friend std::string to_string(const bigint& x) {
+        if (x.mag.empty()) return "0";
+        // 每次除以 10^19，取出 19 位十进制数字
+        const limb chunk = 10000000000000000000ull;
+        bigint t = x;
+        std::string s;
+        while (t) {
+            limb r = t.divide_by_limb(chunk);
+            for (int i = 0; i < 19; ++i) {
+                s.push_back(char('0' + r % 10));
+                r /= 10;
+                if (!t && r == 0) break;
+            }
+        }
+        if (x.negative) s.push_back('-');
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const bigint& x) {
+        return os << to_string(x);
+    }
+};
+
+inline limb_vector bigint::multiply_magnitudes(const limb* a, std::size_t an,
+                                               const limb* b, std::size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn >= toom3_threshold && 3 * bn >= 2 * an) {
+        return toom3_multiply(a, an, b, bn);
+    }
+    limb_vector r;
+    r.resize(an + bn);
+    limb_mul(r.data(), a, an, b, bn);
+    r.trim();
+    return r;
+}
+
+inline limb_vector bigint::toom3_multiply(const limb* a, std::size_t an,
+                                          const limb* b, std::size_t bn) {
+    // 把两个因子各切成三段 x = x2 t^2 + x1 t + x0（t = B^k），在
+    // 0, 1, -1, -2, 无穷远处求值、逐点相乘，再用 Bodrato 的插值序列
+    // 恢复乘积的五个系数。逐点乘法递归调用 bigint 的乘法。
+    std::size_t k = (std::max(an, bn) + 2) / 3;
+    auto part = [k](const limb* p, std::size_t n, std::size_t i) {
+        std::size_t first = std::min(n, i * k);
+        std::size_t last = std::min(n, first + k);
+        return bigint::from_limbs(p + first, last - first);
+    };
+    bigint a0 = part(a, an, 0), a1 = part(a, an, 1), a2 = part(a, an, 2);
+    bigint b0 = part(b, bn, 0), b1 = part(b, bn, 1), b2 = part(b, bn, 2);
+
+    bigint pa = a0 + a2;
+    bigint pb = b0 + b2;
+    bigint a_1 = pa + a1, a_m1 = pa - a1;
+    bigint b_1 = pb + b1, b_m1 = pb - b1;
+    bigint a_m2 = ((a_m1 + a2) << 1) - a0;
+    bigint b_m2 = ((b_m1 + b2) << 1) - b0;
+
+    bigint r0 = a0 * b0;
+    bigint r1 = a_1 * b_1;
+    bigint rm1 = a_m1 * b_m1;
+    bigint rm2 = a_m2 * b_m2;
+    bigint r4 = a2 * b2;
+
+    bigint r3 = (rm2 - r1) / bigint(3);
+    r1 = (r1 - rm1) >> 1;
+    bigint r2 = rm1 - r0;
+    r3 = ((r2 - r3) >> 1) + (r4 << 1);
+    r2 = r2 + r1 - r4;
+    r1 = r1 - r3;
+
+    std::size_t shift = k * limb_bits;
+    bigint result = r0 + (r1 << shift) + (r2 << 2 * shift) + (r3 << 3 * shift)
+                    + (r4 << 4 * shift);
+    return std::move(result.mag);
+}
+
+// ---- 与 ch07、ch12、ch13 的模板配合的重载 ----
+
+inline bool odd(const bigint& n) {
+    return n.size() != 0 && (n.limbs()[0] & 1) != 0;
+}
+
+inline bool even(const bigint& n) { return !odd(n); }
+
+inline bigint half(const bigint& n) { return n >> 1; }
+
+inline int bit_length(const bigint& n) { return n.bit_length(); }
+
+inline bigint remainder(const bigint& a, const bigint& b) { return a % b; }
+
+inline bigint abs(const bigint& n) { return n < bigint(0) ? -n : n; }
+
+// ---- 反复除以同一个数 ----
+
+class bigint_divisor {
+    bigint d;
+    std::vector<limb> v;  // |d| 左移 shift 位，使最高位为 1
+    int shift;
+    limb inverse;         // v 的最高一个（只有一个 limb 时）或两个 limb 的倒数
+
+public:
+    explicit bigint_divisor(const bigint& d) : d(d), v(d.size()) {
+        if (d.size() == 0) throw std::domain_error("bigint: division by zero");
+        std::size_t n = d.size();
+        shift = std::countl_zero(d.limbs()[n - 1]);
+        limb_shift_left(v.data(), d.limbs(), n, shift);
+        inverse = n == 1 ? limb_reciprocal(v[0])
+                         : limb_reciprocal(v[n - 1], v[n - 2]);
+    }
+
+    const bigint& value() const { return d; }
+
+    // 与 quotient_remainder(a, x.value()) 的结果相同
+    friend std::pair<bigint, bigint>
+    quotient_remainder(const bigint& a, const bigint_divisor& x) {
+        std::size_t n = x.v.size();
+        std::size_t an = a.size();
+        if (an < n) return {bigint(), a};
+        std::vector<limb> u(an + 1), q(an + 1 - n);
+        u[an] = limb_shift_left(u.data(), a.limbs(), an, x.shift);
+        if (n == 1) {
+            limb r = u[an];
+            for (std::size_t i = an; i-- != 0; ) {
+                q[i] = limb_div_2by1(r, r, u[i], x.v[0], x.inverse);
+            }
+            u[0] = r;
+        } else {
+            limb_divrem_normalized(q.data(), u.data(), an + 1, x.v.data(), n,
+                                   x.inverse);
+        }
+        limb_shift_right(u.data(), u.data(), n, x.shift);
+        bool negative = a.is_negative();
+        return {bigint::from_limbs(q.data(), q.size(),
+                                   negative != x.d.is_negative()),
+                bigint::from_limbs(u.data(), n, negative)};
+    }
+
+    friend bigint remainder(const bigint& a, const bigint_divisor& x) {
+        return quotient_remainder(a, x).second;
+    }
+};
+
+// 与 ch13.h 的 modulo_multiply<bigint> 结果相同，但约简时不再重复
+// 规范化除数、计算倒数
+struct reciprocal_multiply {
+    bigint_divisor modulus;
+    reciprocal_multiply(const bigint& n) : modulus(n) {}
+
+    bigint operator()(const bigint& a, const bigint& b) const {
+        return remainder(a * b, modulus);
+    }
+};
+
+inline bigint identity_element(const reciprocal_multiply&) {
+    return bigint(1);
+}
+
+inline bigint to_residue(const reciprocal_multiply& op, const bigint& x) {
+    return remainder(x, op.modulus);
+}
+
+inline bigint from_residue(const reciprocal_multiply&, const bigint& x) {
+    return x;
+}
@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------
+// ch13_bigint_bench.cpp -- Multiplication, division and modular
+// exponentiation timings for ch13_bigint.h.
+// -------------------------------------------------------------------
+// 用法：ch13_bigint_bench
+// 第一部分比较各规模下教科书乘法、Karatsuba 和 Toom-3，用来确定
+// karatsuba_threshold 和 toom3_threshold；第二部分比较 2n / n 个 limb
+// 的算法 D 与递归除法，用来确定 divide_recursive_threshold；第三部分是
+// RSA 规模的模幂，约简分别用 modulo_multiply 和 reciprocal_multiply。
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_bigint.h"
+
+volatile limb bench_sink;  // 防止被测的循环被优化掉
+
+template <typename F>
+double time_us(int repeat, F f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < repeat; ++i) f();
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> duration = end - start;
+  return duration.count() / repeat;
+}
+
+bigint random_bigint(std::mt19937_64& random, std::size_t limbs) {
+  std::vector<limb> v(limbs);
+  for (limb& x : v) x = random();
+  v.back() |= limb(1) << 63;
+  return bigint::from_limbs(v.data(), v.size());
+}
+
+int main() {
+  std::mt19937_64 random(2015);
+
+  std::cout << "n x n limb multiplication (us):" << std::endl;
+  std::cout << "  limbs   basecase   limb_mul   bigint *" << std::endl;
+  for (std::size_t n : {8, 16, 24, 32, 48, 64, 128, 256, 512, 1024, 2048, 4096}) {
+    std::vector<limb> a(n), b(n), r(2 * n);
+    for (limb& x : a) x = random();
+    for (limb& x : b) x = random();
+    bigint x = bigint::from_limbs(a.data(), n);
+    bigint y = bigint::from_limbs(b.data(), n);
+    int repeat = std::max(1, int(2000000 / (n * n)));
+    double basecase = time_us(repeat, [&] {
+      limb_mul_basecase(r.data(), a.data(), n, b.data(), n);
+      bench_sink = r[n];
+    });
+    double karatsuba = time_us(repeat, [&] {
+      limb_mul(r.data(), a.data(), n, b.data(), n);
+      bench_sink = r[n];
+    });
+    double full = time_us(repeat, [&] { bench_sink = (x * y).limbs()[0]; });
+    std::cout << "  " << n << "\t  " << basecase << "\t     " << karatsuba
+              << "\t" << full << std::endl;
+  }
+
+  std::cout << "2n / n limb division (us):" << std::endl;
+  std::cout << "  limbs   algorithm D   limb_divrem" << std::endl;
+  for (std::size_t n : {16, 32, 48, 64, 96, 128, 256, 512, 1024, 2048}) {
+    std::vector<limb> a(2 * n), b(n), q(n + 1), r(n);
+    for (limb& x : a) x = random();
+    for (limb& x : b) x = random();
+    b.back() |= limb(1) << 63;
+    std::vector<limb> u(2 * n + 1);
+    limb inverse = limb_reciprocal(b[n - 1], b[n - 2]);
+    int repeat = std::max(1, int(2000000 / (n * n)));
+    double basecase = time_us(repeat, [&] {
+      std::copy(a.begin(), a.end(), u.begin());
+      u[2 * n] = 0;
+      limb_divrem_basecase(q.data(), u.data(), 2 * n + 1, b.data(), n, inverse);
+      bench_sink = u[0];
+    });
+    double full = time_us(repeat, [&] {
+      limb_divrem(q.data(), r.data(), a.data(), 2 * n, b.data(), n);
+      bench_sink = r[0];
+    });
+    std::cout << "  " << n << "\t  " << basecase << "\t" << full << std::endl;
+  }
+
+  std::cout << "modular exponentiation (ms):" << std::endl;
+  std::cout << "  bits   modulo_multiply   reciprocal_multiply" << std::endl;
+  for (std::size_t bits : {1024, 2048, 4096}) {
+    bigint n = random_bigint(random, bits / 64);
+    if (even(n)) n += 1;
+    bigint a = random_bigint(random, bits / 64 - 1);
+    bigint e = random_bigint(random, bits / 64 - 1);
+    int repeat = bits >= 4096 ? 1 : 3;
+    double t = time_us(repeat, [&] {
+      bench_sink = power_semigroup(a, e, modulo_multiply<bigint>(n)).limbs()[0];
+    });
+    double reciprocal = time_us(repeat, [&] {
+      bench_sink = power_semigroup(a, e, reciprocal_multiply(n)).limbs()[0];
+    });
+    std::cout << "  " << bits << "\t  " << t / 1000 << "\t\t    "
+              << reciprocal / 1000 << std::endl;
+  }
+}
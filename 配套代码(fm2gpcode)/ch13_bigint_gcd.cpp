@@ -0,0 +1,84 @@
+// -------------------------------------------------------------------
+// ch13_bigint_gcd.cpp -- For testing ch13_bigint_gcd.h.
+// -------------------------------------------------------------------
+// 用法：ch13_bigint_gcd
+// 与 ch12.h 的模板（显式写出 gcd<bigint>）逐一对照，再比较两者的耗时。
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_bigint.h"
+#include "ch13_bigint_gcd.h"
+
+bigint random_bigint(std::mt19937_64& random, std::size_t limbs) {
+  std::vector<limb> v(limbs);
+  for (limb& x : v) x = random();
+  return bigint::from_limbs(v.data(), v.size(), random() & 1);
+}
+
+template <typename F>
+double time_ms(F f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> duration = end - start;
+  return duration.count();
+}
+
+bool agrees(const bigint& a, const bigint& b) {
+  return gcd(a, b) == gcd<bigint>(a, b)
+         && extended_gcd(a, b) == extended_gcd<bigint>(a, b);
+}
+
+int main() {
+  std::mt19937_64 random(2015);
+
+  // 随机数、有公因子的数、整除、相等和 0
+  bool same = true;
+  // 600、1100 个 limb 超过 gcd_recursive_threshold，走 half_gcd
+  for (std::size_t n : {1, 2, 3, 8, 40, 63, 64, 65, 150, 400, 600, 1100}) {
+    for (int t = 0; t < 4; ++t) {
+      bigint a = random_bigint(random, n);
+      bigint b = random_bigint(random, n - t % 2 * (n / 3));
+      bigint c = random_bigint(random, n / 2 + 1);
+      if (!agrees(a, b) || !agrees(b, a) || !agrees(a * c, b * c)
+          || !agrees(a * b, b) || !agrees(a, a) || !agrees(a, -a)
+          || !agrees(a, 0) || !agrees(0, b)) {
+        same = false;
+      }
+    }
+  }
+  // 相邻的斐波那契数：每个商都是 1，步数最多；F(70000) 约有 760 个 limb，
+  // 超过 gcd_recursive_threshold
+  bigint f0 = 0, f1 = 1;
+  for (int i = 0; i < 70000; ++i) {
+    f0 += f1;
+    std::swap(f0, f1);
+    if (i < 30000 && i % 997 == 0 && !agrees(f1, f0)) same = false;
+  }
+  if (!agrees(f1, f0)) same = false;
+  std::cout << "gcd and extended_gcd agree with ch12.h: " << same << std::endl;
+
+  // ch13.h 的 multiplicative_inverse 直接用上新的 extended_gcd
+  bigint p = power_monoid(bigint(2), 9689) - 1;  // 梅森素数
+  bigint a = random_bigint(random, 100);
+  bigint inverse = multiplicative_inverse(abs(a), p);
+  std::cout << "multiplicative_inverse(a, 2^9689 - 1) * a mod p = "
+            << inverse * abs(a) % p << std::endl;
+
+  std::cout << "gcd of two n-limb numbers (ms):" << std::endl;
+  std::cout << "  limbs   ch12.h   lehmer/half_gcd   extended_gcd" << std::endl;
+  for (std::size_t n : {16, 64, 256, 1024, 4096}) {
+    bigint x = abs(random_bigint(random, n));
+    bigint y = abs(random_bigint(random, n));
+    double classic = n <= 1024 ? time_ms([&] { gcd<bigint>(x, y); }) : 0;
+    double fast = time_ms([&] { gcd(x, y); });
+    double extended = time_ms([&] { extended_gcd(x, y); });
+    std::cout << "  " << n << "\t  " << classic << "\t   " << fast
+              << "\t\t     " << extended << std::endl;
+  }
+}
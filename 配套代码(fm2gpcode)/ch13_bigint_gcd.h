@@ -0,0 +1,223 @@
+// -------------------------------------------------------------------
+// ch13_bigint_gcd.h -- Lehmer's algorithm and half-gcd for bigint
+// (extension of Chapters 12 and 13 of fM2GP).
+// -------------------------------------------------------------------
+// ch12.h 的 gcd 和 extended_gcd 每走一步都要做一次全长的
+// quotient_remainder；对 n 个 limb 的数，步数约为 n 的 75 倍，总代价是
+// n^2 量级且常数很大。这里给 bigint 提供同名重载，结果（包括负数输入时
+// 的符号和 extended_gcd 返回的系数）与 ch12.h 的模板完全相同，
+// ch13.h 的 multiplicative_inverse 不加修改就会用上。
+//
+// 欧几里得算法的连续 k 步可以合成一个 2x2 矩阵：
+//
+//     (a, b) = M (r_k, r_{k+1})，M = [q_1 1; 1 0] ... [q_k 1; 1 0]，
+//
+// M 的元素非负，det M = (-1)^k，r_k、r_{k+1} 关于 a、b 的系数的绝对值
+// 就是 M 的元素。
+//
+// Lehmer 算法：只在 a、b 的最高 64 位上模拟若干步，把这些步合成的矩阵
+// 一次作用到全长的数上。模拟出的商是否与真实的商相同，用 Jebelean 的
+// 条件判断：若
+//
+//     r_{k+1} >= max(m00, m10)，r_k - r_{k+1} >= max(m00 + m01, m10 + m11)，
+//
+// 则在 a、b 后面任意添加低位，前 k 步的商都不变（称这些步是稳健的）。
+// 当 a、b 不超过 64 位时直接在机器字上算完，不需要这个条件。
+//
+// half_gcd：对 n 位的 a、b，稳健的步一直可以走到余数约剩 n / 2 位。先在
+// 最高一半上递归求出矩阵，作用到全长的数上；剩下的距离再对新的最高部分
+// 递归；每次都检查合成后的矩阵仍然稳健，不满足就改用 Lehmer 步或单步。
+// 乘法是 Karatsuba 时总代价为 O(n^1.58 log n)。a 不小于
+// gcd_recursive_threshold 个 limb 时 gcd 调用 half_gcd，否则用 Lehmer 步。
+//
+// 使用前需先包含 ch12.h 和 ch13_bigint.h。
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+// a 的 limb 数不小于这个值时，gcd 和 extended_gcd 用 half_gcd，否则用
+// Lehmer 步
+const std::size_t gcd_recursive_threshold = 512;
+
+// half_gcd 内部：还能走的距离不小于这个 limb 数时对最高部分递归
+const std::size_t half_gcd_threshold = 32;
+
+// 欧几里得算法若干步合成的矩阵；odd 为 true 时步数为奇数（det = -1）
+struct euclid_matrix {
+    bigint m00 = 1;
+    bigint m01 = 0;
+    bigint m10 = 0;
+    bigint m11 = 1;
+    bool odd = false;
+};
+
+inline bool is_identity(const euclid_matrix& m) {
+    return m.m01 == 0;  // 走过一步后 m01 至少为 1
+}
+
+// m * p
+inline euclid_matrix operator*(const euclid_matrix& m, const euclid_matrix& p) {
+    return {m.m00 * p.m00 + m.m01 * p.m10, m.m00 * p.m01 + m.m01 * p.m11,
+            m.m10 * p.m00 + m.m11 * p.m10, m.m10 * p.m01 + m.m11 * p.m11,
+            m.odd != p.odd};
+}
+
+// (a, b) = M^{-1} (a, b)；M 是欧几里得算法的一步 [q 1; 1 0] 时即
+// (a, b) = (b, a - qb)。对余因子同样适用。
+inline void apply_inverse(const euclid_matrix& m, bigint& a, bigint& b) {
+    bigint x = m.m11 * a - m.m01 * b;
+    bigint y = m.m00 * b - m.m10 * a;
+    if (m.odd) {
+        x = -x;
+        y = -y;
+    }
+    a = std::move(x);
+    b = std::move(y);
+}
+
+// Jebelean 条件：(a, b) 是某对数经过 m 的各步得到的余数，且这些步对
+// 那对数任意添加低位后仍然成立
+inline bool is_robust(const bigint& a, const bigint& b, const euclid_matrix& m) {
+    return b >= std::max(m.m00, m.m10)
+           && a - b >= std::max(m.m00 + m.m01, m.m10 + m.m11);
+}
+
+// floor(|x| / 2^k) 的低 64 位
+inline limb leading_limb(const bigint& x, int k) {
+    std::size_t i = k / limb_bits;
+    int s = k % limb_bits;
+    const limb* p = x.limbs();
+    limb r = i < x.size() ? p[i] >> s : 0;
+    if (s != 0 && i + 1 < x.size()) r |= p[i + 1] << (limb_bits - s);
+    return r;
+}
+
+// 在 a、b 的最高 64 位上模拟欧几里得算法，返回对 (a, b) 成立的若干步，
+// 矩阵元素不超过 bound
+inline euclid_matrix lehmer_matrix(const bigint& a, const bigint& b,
+                                   limb bound) {
+    // precondition: a > b >= 0
+    int k = std::max(0, bit_length(a) - limb_bits);
+    limb x = leading_limb(a, k);
+    limb y = leading_limb(b, k);
+    bool exact = k == 0;  // a、b 本身就在一个字里，每一步都是真实的
+    limb m00 = 1, m01 = 0, m10 = 0, m11 = 1;
+    bool odd = false;
+    while (y != 0) {
+        limb q = x / y;
+        limb r = x - q * y;
+        double_limb n00 = double_limb(q) * m00 + m01;
+        double_limb n10 = double_limb(q) * m10 + m11;
+        if (n00 > bound || n10 > bound) break;
+        if (!exact && (r < std::max(n00, n10)
+                       || y - r < std::max(n00 + m00, n10 + m10))) {
+            break;
+        }
+        m01 = m00;
+        m00 = limb(n00);
+        m11 = m10;
+        m10 = limb(n10);
+        odd = !odd;
+        x = y;
+        y = r;
+    }
+    return {m00, m01, m10, m11, odd};
+}
+
+// 欧几里得算法的一步
+inline euclid_matrix euclid_step(const bigint& a, const bigint& b) {
+    return {a / b, 1, 1, 0, true};
+}
+
+// 若 m * p 仍然稳健，就把 p 的各步作用到 (a, b) 上并合成到 m 中
+inline bool try_steps(bigint& a, bigint& b, euclid_matrix& m,
+                      const euclid_matrix& p) {
+    bigint x = a;
+    bigint y = b;
+    apply_inverse(p, x, y);
+    euclid_matrix mp = m * p;
+    if (!is_robust(x, y, mp)) return false;
+    a = std::move(x);
+    b = std::move(y);
+    m = std::move(mp);
+    return true;
+}
+
+// 在 (a, b) 上尽量多走稳健的步，合成到 m 中
+inline void half_gcd(bigint& a, bigint& b, euclid_matrix& m) {
+    // precondition: a > b >= 0 && is_robust(a, b, m)
+    while (b != 0) {
+        // 再走 t 位，m 的元素约增长 t 位，b 约减少 t 位；稳健要求 b 不小于 m
+        // 的元素，所以还能走的距离约为 gap / 2
+        int gap = bit_length(b) - std::max(bit_length(m.m00), bit_length(m.m10));
+        int n = bit_length(a);
+        int size = std::min(gap - limb_bits, n / 2);
+        if (size >= int(half_gcd_threshold * limb_bits)) {
+            // 最高 size 位上的稳健步对全长的数也成立
+            int k = n - size;
+            bigint x = a >> k;
+            bigint y = b >> k;
+            euclid_matrix p;
+            half_gcd(x, y, p);
+            if (!is_identity(p) && try_steps(a, b, m, p)) continue;
+        }
+        if (gap > 2) {
+            int t = std::min(limb_bits - 1, gap / 2 - 1);
+            euclid_matrix p = lehmer_matrix(a, b, limb(1) << t);
+            if (!is_identity(p) && try_steps(a, b, m, p)) continue;
+        }
+        if (!try_steps(a, b, m, euclid_step(a, b))) return;
+    }
+}
+
+// |a| 与 |b| 的欧几里得算法；a 变为 gcd，xa 变为它关于 |a| 的系数
+// （xa、xb 为空时不记录）。返回步数是否为奇数。
+inline bool euclid_magnitude(bigint& a, bigint& b, bigint* xa, bigint* xb) {
+    // precondition: a >= 0 && b >= 0
+    bool odd = false;
+    if (a < b) {
+        // 商为 0 的一步
+        std::swap(a, b);
+        if (xa) std::swap(*xa, *xb);
+        odd = true;
+    }
+    while (b != 0) {
+        euclid_matrix p;
+        if (a.size() >= gcd_recursive_threshold) {
+            half_gcd(a, b, p);
+        } else {
+            p = lehmer_matrix(a, b, ~limb(0));
+            apply_inverse(p, a, b);
+        }
+        if (is_identity(p)) {
+            p = euclid_step(a, b);
+            apply_inverse(p, a, b);
+        }
+        if (xa) apply_inverse(p, *xa, *xb);
+        odd = odd != p.odd;
+    }
+    return odd;
+}
+
+// ch12.h 的 gcd 中，余数与被除数同号，所以结果在步数为偶数时与 a 同号，
+// 为奇数时与 b 同号
+inline bigint gcd(const bigint& a, const bigint& b) {
+    bigint x = abs(a);
+    bigint y = abs(b);
+    bool odd = euclid_magnitude(x, y, nullptr, nullptr);
+    return (odd ? b : a).is_negative() ? -x : x;
+}
+
+// 与 ch12.h 的 extended_gcd 相同：返回 x 和 gcd(a, b)，ax + by = gcd(a, b)
+inline std::pair<bigint, bigint> extended_gcd(const bigint& a, const bigint& b) {
+    bigint g = abs(a);
+    bigint y = abs(b);
+    bigint x0 = 1;
+    bigint x1 = 0;
+    bool odd = euclid_magnitude(g, y, &x0, &x1);
+    // 余数 r_k 与 (k 为偶数时) a 或 (奇数时) b 同号，系数随之变号
+    if (odd && a.is_negative() != b.is_negative()) x0 = -x0;
+    if ((odd ? b : a).is_negative()) g = -g;
+    return {x0, g};
+}
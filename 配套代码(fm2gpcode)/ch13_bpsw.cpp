@@ -0,0 +1,87 @@
+// -------------------------------------------------------------------
+// ch13_bpsw.cpp -- For testing ch13_bpsw.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_prime_u64.h"
+#include "ch13_bpsw.h"
+
+typedef unsigned __int128 U128;
+
+std::string to_string(U128 n) {
+  std::string s;
+  do {
+    s.insert(s.begin(), char('0' + int(n % 10)));
+    n /= 10;
+  } while (n != 0);
+  return s;
+}
+
+int main() {
+  typedef std::uint64_t U;
+
+  bool same = true;
+  for (U n = 0; n < 1000000; ++n) {
+    if (is_probable_prime(n) != bool(is_prime(n))) same = false;
+  }
+  std::cout << "is_probable_prime agrees with is_prime below 10^6: " << same
+            << std::endl;
+
+  same = true;
+  for (U n = 1000000000000000000ull; n < 1000000000000100000ull; ++n) {
+    if (is_probable_prime(n) != is_prime_u64(n)) same = false;
+  }
+  std::cout << "is_probable_prime agrees with is_prime_u64 on "
+            << "[10^18, 10^18 + 10^5): " << same << std::endl;
+
+  // 以 2 为底的强伪素数，Lucas 测试把它们挡住
+  std::cout << "strong pseudoprimes to base 2:";
+  for (U n : {2047, 3277, 4033, 4681, 8321}) {
+    std::cout << " " << n << ":" << is_probable_prime(n);
+  }
+  std::cout << std::endl;
+  // 强 Lucas 伪素数，以 2 为底的测试把它们挡住
+  std::cout << "strong Lucas pseudoprimes:";
+  for (U n : {5459, 5777, 10877, 16109, 18971}) {
+    std::cout << " " << n << ":" << is_probable_prime(n)
+              << "/" << strong_lucas_test(n, modulo_multiply<U>(n));
+  }
+  std::cout << std::endl;
+
+  // 其他 64 位及更窄的类型同样走 Montgomery 路径，n * n 不会溢出
+  unsigned long long p = 18446744073709551557ull;  // 2^64 - 59
+  unsigned long long c = 4294967291ull * 4294967279ull;
+  std::cout << "unsigned long long: is_probable_prime(2^64 - 59) = "
+            << is_probable_prime(p) << ", is_probable_prime("
+            << "4294967291 * 4294967279) = " << is_probable_prime(c)
+            << std::endl;
+  std::cout << "long long: is_probable_prime(2^61 - 1) = "
+            << is_probable_prime((1ll << 61) - 1)
+            << ", std::uint32_t: is_probable_prime(4294967291) = "
+            << is_probable_prime(std::uint32_t(4294967291u)) << std::endl;
+
+  U128 m89 = (U128(1) << 89) - 1;
+  U128 m127 = (U128(1) << 127) - 1;
+  U128 p64 = 18446744073709551557ull;
+  std::cout << "is_probable_prime(2^89 - 1) = " << is_probable_prime(m89)
+            << std::endl;
+  std::cout << "is_probable_prime(2^127 - 1) = " << is_probable_prime(m127)
+            << std::endl;
+  std::cout << "is_probable_prime(2^127 + 1) = "
+            << is_probable_prime(m127 + 2) << std::endl;
+  std::cout << "is_probable_prime((2^64 - 59)^2) = "
+            << is_probable_prime(p64 * p64) << std::endl;
+  std::cout << "is_probable_prime((2^61 - 1) * (2^64 - 59)) = "
+            << is_probable_prime(((U128(1) << 61) - 1) * p64) << std::endl;
+
+  U128 x = (U128(1) << 100) + 1;
+  while (!is_probable_prime(x)) x += 2;
+  std::cout << "first probable prime above 2^100: " << to_string(x)
+            << std::endl;
+}
@@ -0,0 +1,211 @@
+// -------------------------------------------------------------------
+// ch13_bpsw.h -- Baillie-PSW probable-prime test
+// (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// BPSW = 以 2 为底的强伪素数测试（miller_rabin_test）+ 强 Lucas 测试。
+// 至今没有发现能同时通过两者的合数，而代价大约相当于 3 轮米勒-拉宾。
+//
+// Lucas 序列用 Selfridge 方法 A 选参数：在 5, -7, 9, -11, ... 中找第一个
+// 使雅可比符号 (D/n) = -1 的 D，取 P = 1，Q = (1 - D) / 4。
+// 三元组 (U_k, V_k, Q^k) 在运算
+//
+//     U_{j+k} = (U_j V_k + U_k V_j) / 2
+//     V_{j+k} = (V_j V_k + D U_j U_k) / 2
+//     Q^{j+k} = Q^j Q^k
+//
+// 下构成半群（它就是伴随矩阵 [[P, -Q], [1, 0]] 的幂的另一种写法），
+// 所以 U_d、V_d 可以直接用 power_semigroup 求出。所有剩余类都以 op 的
+// 表示（Montgomery 形式或普通余数）存放；除以 2 对两种表示都适用。
+//
+// 模板对整数类型是泛型的：不超过 64 位的内置整数类型（unsigned long、
+// unsigned long long、有符号类型等）都换成 std::uint64_t，与
+// unsigned __int128 一样使用 Montgomery 乘法；其他类型（例如多精度
+// 整数）使用 modulo_multiply，要求 n * n 不会溢出。
+// 使用前需先包含 ch07.h、ch12.h、ch13.h 和 ch13_montgomery.h。
+
+#include <cstdint>
+#include <type_traits>
+
+#define Integer typename
+#define ModularMultiplication typename
+
+template <Integer I>
+I add_mod(const I& a, const I& b, const I& n) {
+    // precondition: a < n && b < n；不会溢出
+    return a >= n - b ? a - (n - b) : a + b;
+}
+
+template <Integer I>
+I subtract_mod(const I& a, const I& b, const I& n) {
+    return a >= b ? a - b : n - (b - a);
+}
+
+template <Integer I>
+I half_mod(const I& a, const I& n) {
+    // a / 2 mod n，n 为奇数：a 为奇数时 (a + n) / 2 = (a - 1) / 2 + (n - 1) / 2 + 1
+    if (even(a)) return a >> 1;
+    return (a >> 1) + (n >> 1) + I(1);
+}
+
+template <Integer I>
+int jacobi_symbol(I a, I n) {
+    // precondition: n is odd && n > 0
+    a = a % n;
+    int t = 1;
+    while (a != I(0)) {
+        while (even(a)) {
+            a = a >> 1;
+            I r = n % I(8);
+            if (r == I(3) || r == I(5)) t = -t;
+        }
+        std::swap(a, n);
+        if (a % I(4) == I(3) && n % I(4) == I(3)) t = -t;
+        a = a % n;
+    }
+    return n == I(1) ? t : 0;
+}
+
+template <Integer I>
+I integer_square_root(const I& n) {
+    // floor(sqrt(n))，牛顿迭代
+    if (n < I(2)) return n;
+    I x = n;
+    I y = (x >> 1) + (x & I(1));
+    while (y < x) {
+        x = y;
+        y = (x + n / x) >> 1;
+    }
+    return x;
+}
+
+template <Integer I>
+struct lucas_element {
+    I u, v, qk;  // U_k, V_k, Q^k
+};
+
+template <Integer I>
+bool operator==(const lucas_element<I>& x, const lucas_element<I>& y) {
+    return x.u == y.u && x.v == y.v && x.qk == y.qk;
+}
+
+template <Integer I, ModularMultiplication Op>
+struct lucas_step {
+    Op op;
+    I n;
+    I d;  // D 的剩余类表示
+
+    lucas_element<I> operator()(const lucas_element<I>& x,
+                                const lucas_element<I>& y) const {
+        I u = half_mod(add_mod(op(x.u, y.v), op(y.u, x.v), n), n);
+        I v = half_mod(add_mod(op(x.v, y.v), op(d, op(x.u, y.u)), n), n);
+        return {u, v, op(x.qk, y.qk)};
+    }
+};
+
+template <Integer I, ModularMultiplication Op>
+I signed_residue(const Op& op, const I& magnitude, bool negative,
+                 const I& n) {
+    // 小整数 ±magnitude 的剩余类表示
+    I r = to_residue(op, magnitude);
+    return negative && r != I(0) ? n - r : r;
+}
+
+template <Integer I, ModularMultiplication Op>
+bool strong_lucas_test(I n, Op op) {
+    // precondition: n is odd && n > 2 && n is not a perfect square
+    //               && op multiplies modulo n
+    I d_abs(5);
+    bool d_negative = false;
+    while (true) {
+        I d = signed_residue(op, d_abs, d_negative, n);
+        int j = jacobi_symbol(from_residue(op, d), n);
+        if (j == -1) break;
+        if (j == 0 && d_abs < n) return false;  // gcd(D, n) 是 n 的真因子
+        d_abs = d_abs + I(2);
+        d_negative = !d_negative;
+    }
+    // Q = (1 - D) / 4
+    I q_abs = d_negative ? (d_abs + I(1)) / I(4) : (d_abs - I(1)) / I(4);
+    bool q_negative = !d_negative;
+
+    lucas_step<I, Op> step = {op, n,
+                              signed_residue(op, d_abs, d_negative, n)};
+    I one = identity_element(op);
+    lucas_element<I> first = {one, one,  // U_1 = 1, V_1 = P = 1
+                              signed_residue(op, q_abs, q_negative, n)};
+
+    // n + 1 = 2^s d
+    I d = n + I(1);
+    int s = 0;
+    while (even(d)) {
+        d = d >> 1;
+        ++s;
+    }
+    lucas_element<I> x = power_semigroup(first, d, step);
+    if (x.u == I(0) || x.v == I(0)) return true;
+    for (int r = 1; r < s; ++r) {
+        // invariant: x.v = V_{2^{r-1} d}, x.qk = Q^{2^{r-1} d}
+        x.v = subtract_mod(op(x.v, x.v), add_mod(x.qk, x.qk, n), n);
+        if (x.v == I(0)) return true;
+        x.qk = op(x.qk, x.qk);
+    }
+    return false;
+}
+
+template <Integer I, ModularMultiplication Op>
+bool baillie_psw_test(I n, Op op) {
+    // precondition: n is odd && n > 2 && op multiplies modulo n
+    I q = n - I(1);
+    I k(0);
+    while (even(q)) {
+        q = q >> 1;
+        ++k;
+    }
+    if (!miller_rabin_test(n, q, k, I(2), op)) return false;
+    I r = integer_square_root(n);
+    if (r * r == n) return false;
+    return strong_lucas_test(n, op);
+}
+
+template <Integer I>
+bool small_prime_or_composite(const I& n, bool& result) {
+    // 用小素数试除；能直接下结论时返回 true，结论写入 result
+    static const int small_primes[] = {
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47
+    };
+    if (n < I(2)) {
+        result = false;
+        return true;
+    }
+    for (int p : small_primes) {
+        if (n % I(p) == I(0)) {
+            result = n == I(p);
+            return true;
+        }
+    }
+    if (n < I(53 * 53)) {
+        result = true;
+        return true;
+    }
+    return false;
+}
+
+template <Integer I>
+bool is_probable_prime(const I& n) {
+    bool result;
+    if (small_prime_or_composite(n, result)) return result;
+    if constexpr (std::is_integral_v<I> && sizeof(I) <= sizeof(std::uint64_t)) {
+        // modulo_multiply<I> 在 n > 2^(w/2) 时溢出；这里 n >= 53^2 > 0
+        std::uint64_t m(n);
+        return baillie_psw_test(m, montgomery_multiply<std::uint64_t>(m));
+    } else {
+        return baillie_psw_test(n, modulo_multiply<I>(n));
+    }
+}
+
+inline bool is_probable_prime(const unsigned __int128& n) {
+    bool result;
+    if (small_prime_or_composite(n, result)) return result;
+    if (n >> 64 == 0) return is_probable_prime(std::uint64_t(n));
+    return baillie_psw_test(n, montgomery_multiply<unsigned __int128>(n));
+}
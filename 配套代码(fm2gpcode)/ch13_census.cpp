@@ -0,0 +1,91 @@
+// -------------------------------------------------------------------
+// ch13_census.cpp -- Census tool for ch13_census.h.
+// -------------------------------------------------------------------
+// 用法：ch13_census [hi [lo [线程数 [输出文件]]]]
+//
+// 默认统计 [3, 10^8)。每找到一个以 2 为底的费马伪素数，就向输出文件写
+// 一行：数本身，后面跟 psp，若是强伪素数再跟 spsp，若是卡迈克尔数再跟
+// carmichael。每处理完一段都会写检查点 <输出文件>.checkpoint；中断后
+// 用相同的参数重新运行，会从检查点继续。
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "ch03.h"
+#include "ch03_segmented.h"
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_census.h"
+
+struct census_checkpoint {
+    std::uint64_t lo, hi, segment, next, output_size;
+    std::uint64_t psp, spsp, carmichael;
+};
+
+bool read_checkpoint(const std::string& path, census_checkpoint& c) {
+    std::ifstream in(path);
+    return bool(in >> c.lo >> c.hi >> c.segment >> c.next >> c.output_size
+                   >> c.psp >> c.spsp >> c.carmichael);
+}
+
+void write_checkpoint(const std::string& path, const census_checkpoint& c) {
+    // 先写临时文件再改名，中途崩溃也不会留下半个检查点
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        out << c.lo << " " << c.hi << " " << c.segment << " " << c.next << " "
+            << c.output_size << " " << c.psp << " " << c.spsp << " "
+            << c.carmichael << std::endl;
+    }
+    std::filesystem::rename(tmp, path);
+}
+
+int main(int argc, char* argv[]) {
+  census_checkpoint c = {};
+  c.hi = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+  c.lo = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 3;
+  unsigned threads = argc > 3 ? std::atoi(argv[3])
+                              : std::max(1u, std::thread::hardware_concurrency());
+  std::string output = argc > 4 ? argv[4] : "census.txt";
+  std::string checkpoint = output + ".checkpoint";
+  c.segment = 1 << 20;
+
+  census_checkpoint saved;
+  if (read_checkpoint(checkpoint, saved) && saved.lo == c.lo &&
+      saved.hi == c.hi && saved.segment == c.segment &&
+      std::filesystem::exists(output)) {
+    c = saved;
+    // 丢掉检查点之后才写入的行，它们所在的段会重新处理
+    std::filesystem::resize_file(output, c.output_size);
+    std::cout << "resuming at segment " << c.next << std::endl;
+  } else {
+    std::ofstream(output, std::ios::trunc);
+  }
+
+  std::ofstream out(output, std::ios::app);
+  census(c.lo, c.hi, c.segment, c.next, threads,
+         [&](std::uint64_t k, const std::vector<census_hit>& hits) {
+           for (const census_hit& h : hits) {
+             out << h.n << " psp";
+             if (h.strong) out << " spsp";
+             if (h.carmichael) out << " carmichael";
+             out << "\n";
+             ++c.psp;
+             c.spsp += h.strong;
+             c.carmichael += h.carmichael;
+           }
+           out.flush();
+           c.next = k + 1;
+           c.output_size = std::uint64_t(out.tellp());
+           write_checkpoint(checkpoint, c);
+         });
+
+  std::cout << "[" << c.lo << ", " << c.hi << "): "
+            << c.psp << " base-2 Fermat pseudoprimes, "
+            << c.spsp << " base-2 strong pseudoprimes, "
+            << c.carmichael << " Carmichael numbers" << std::endl;
+}
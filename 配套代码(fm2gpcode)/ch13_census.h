@@ -0,0 +1,201 @@
+// -------------------------------------------------------------------
+// ch13_census.h -- Census of Carmichael numbers and base-2 Fermat and
+// strong pseudoprimes (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 按段处理奇数，每段做一次“分解筛”：对每个不超过 sqrt(hi) 的奇素数 p，
+// 沿 p 的奇数倍 m = p * k 走一遍，累乘已找到的素因子，同时维护两个
+// 余数，全程不做除法：
+//
+//   (k - 1) mod (p - 1)    为 0 当且仅当 (p - 1) | (m - 1)   （Korselt）
+//   (m - 1) mod ord_p(2)   为 0 当且仅当 2^(m-1) = 1 (mod p)  （费马）
+//
+// k 每次加 2，m 每次加 2p，两个余数都只需加一个常数再视情况减去模数。
+// 筛完后每个数至多剩下一个大于 sqrt(hi) 的素因子 q，对少数通过筛选的
+// 候选再检查 q。候选最后交给 ch13.h 的 fermat_test 确认，再用
+// miller_rabin_test 判断是否为强伪素数。卡迈克尔数都是以 2 为底的
+// 费马伪素数，因此一并在这些候选中找出。
+//
+// 费马伪素数要求 p^2 | m 时 ord_{p^2}(2) | m - 1；由于 p 不整除 m - 1，
+// 这只可能发生在 ord_{p^2}(2) = ord_p(2) 的 Wieferich 素数（1093 和
+// 3511）上。
+//
+// 模乘使用 modulo_multiply<unsigned __int128>，对小于 2^64 的模数不会
+// 溢出。使用前需先包含 ch03.h、ch03_segmented.h、ch07.h、ch12.h 和
+// ch13.h。
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef unsigned __int128 census_wide;
+
+struct census_prime {
+    std::uint64_t p;
+    std::uint64_t order;  // ord_p(2)
+};
+
+struct census_hit {
+    std::uint64_t n;
+    bool strong;       // 以 2 为底的强伪素数
+    bool carmichael;
+};
+
+inline std::uint64_t multiplicative_order_2(std::uint64_t p,
+                                            const std::vector<std::uint64_t>&
+                                                small_primes) {
+    // precondition: p is an odd prime < 2^32
+    // small_primes 包含所有不超过 sqrt(p) 的奇素数
+    modulo_multiply<std::uint64_t> mult(p);
+    std::uint64_t order = p - 1;
+    std::uint64_t r = p - 1;
+    while (r % 2 == 0) r /= 2;
+    std::vector<std::uint64_t> factors(1, 2);
+    for (std::uint64_t f : small_primes) {
+        if (f * f > r) break;
+        if (r % f == 0) {
+            factors.push_back(f);
+            while (r % f == 0) r /= f;
+        }
+    }
+    if (r > 1) factors.push_back(r);
+    for (std::uint64_t f : factors) {
+        while (order % f == 0 &&
+               power_semigroup(std::uint64_t(2), order / f, mult) == 1) {
+            order /= f;
+        }
+    }
+    return order;
+}
+
+inline std::vector<census_prime> census_primes(std::uint64_t hi) {
+    // 所有满足 p * p < hi 的奇素数及其 ord_p(2)
+    // precondition: 3 <= hi <= 2^63
+    // 用有符号类型筛：ch03.h 的 mark_sieve 把迭代器之差与 factor 比较
+    std::vector<std::int64_t> sieved = sieving_primes(std::int64_t(hi - 1));
+    std::vector<std::uint64_t> odd(sieved.begin(), sieved.end());
+    std::vector<census_prime> result;
+    for (std::uint64_t p : odd) {
+        result.push_back({p, multiplicative_order_2(p, odd)});
+    }
+    return result;
+}
+
+inline bool census_wieferich(std::uint64_t p) {
+    return p == 1093 || p == 3511;
+}
+
+inline void census_segment(std::uint64_t lo, std::uint64_t hi,
+                           const std::vector<census_prime>& primes,
+                           std::vector<census_hit>& hits) {
+    // 处理 [lo, hi) 中的奇数，把找到的伪素数按递增顺序追加到 hits
+    // precondition: 3 <= lo && primes == census_primes(h) for some h >= hi
+    typedef std::uint64_t N;
+    const unsigned char korselt_fails = 1;
+    const unsigned char fermat_fails = 2;
+    const unsigned char square = 4;
+
+    N first = lo | 1;
+    if (first >= hi) return;
+    N s = (hi - first + 1) / 2;  // 段内奇数的个数，第 i 个是 first + 2i
+    std::vector<N> prod(s, 1);
+    std::vector<unsigned char> count(s, 0);
+    std::vector<unsigned char> flags(s, 0);
+
+    for (const census_prime& cp : primes) {
+        N p = cp.p;
+        if (p > (hi - 1) / p) break;
+        N m = (first + p - 1) / p * p;
+        if (m % 2 == 0) m += p;
+        if (m < hi) {
+            N r1 = (m / p - 1) % (p - 1);
+            N step1 = 2 % (p - 1);
+            N r2 = (m - 1) % cp.order;
+            N step2 = (2 * p) % cp.order;
+            for (N i = (m - first) / 2; i < s; i += p) {
+                prod[i] *= p;
+                ++count[i];
+                if (r1 != 0) flags[i] |= korselt_fails;
+                if (r2 != 0) flags[i] |= fermat_fails;
+                r1 += step1;
+                if (r1 >= p - 1) r1 -= p - 1;
+                r2 += step2;
+                if (r2 >= cp.order) r2 -= cp.order;
+            }
+        }
+        N q = p * p;
+        if (q >= hi) continue;
+        m = std::max(q, (first + q - 1) / q * q);
+        if (m % 2 == 0) m += q;
+        unsigned char f = census_wieferich(p) ? square
+                                              : square | fermat_fails;
+        for (N i = (m - first) / 2; i < s; i += q) flags[i] |= f;
+    }
+
+    for (N i = 0; i < s; ++i) {
+        N n = first + 2 * i;
+        if (flags[i] & fermat_fails) continue;
+        if (count[i] == 0) continue;                     // 素数
+        if (count[i] == 1 && prod[i] == n && !(flags[i] & square)) continue;
+        N q = 1;                                         // 大素因子
+        if (!(flags[i] & square)) {
+            q = n / prod[i];
+            if (q > 1) {
+                // 2^(n-1) = 1 (mod q)，指数可以先对 q - 1 取模
+                modulo_multiply<census_wide> mult(q);
+                if (power_monoid(census_wide(2), census_wide((n - 1) % (q - 1)),
+                                 mult) != 1) {
+                    continue;
+                }
+            }
+        }
+        if (!fermat_test(census_wide(n), census_wide(2))) continue;
+        N k = 0;
+        N odd = n - 1;
+        while (odd % 2 == 0) { odd /= 2; ++k; }
+        bool strong = miller_rabin_test(census_wide(n), census_wide(odd),
+                                        census_wide(k), census_wide(2));
+        bool carmichael = !(flags[i] & (korselt_fails | square)) &&
+                          (q == 1 || (n - 1) % (q - 1) == 0);
+        hits.push_back({n, strong, carmichael});
+    }
+}
+
+template <typename F>
+void census(std::uint64_t lo, std::uint64_t hi, std::uint64_t segment,
+            std::uint64_t first_segment, unsigned threads, F commit) {
+    // 把 [lo, hi) 切成长度为 segment 的段，从第 first_segment 段开始，
+    // 由 threads 个线程并行处理；commit(k, hits) 按段号递增的顺序调用，
+    // 适合在其中写检查点
+    // precondition: 3 <= lo <= hi <= 2^63
+    std::vector<census_prime> primes = census_primes(hi);
+    std::uint64_t segments = (hi - lo + segment - 1) / segment;
+    std::atomic<std::uint64_t> next(first_segment);
+    std::mutex m;
+    std::map<std::uint64_t, std::vector<census_hit>> done;
+    std::uint64_t committed = first_segment;
+
+    auto work = [&] {
+        while (true) {
+            std::uint64_t k = next.fetch_add(1);
+            if (k >= segments) return;
+            std::vector<census_hit> hits;
+            std::uint64_t a = lo + k * segment;
+            census_segment(std::max<std::uint64_t>(a, 3),
+                           std::min(a + segment, hi), primes, hits);
+            std::lock_guard<std::mutex> lock(m);
+            done[k].swap(hits);
+            while (!done.empty() && done.begin()->first == committed) {
+                commit(committed, done.begin()->second);
+                done.erase(done.begin());
+                ++committed;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work);
+    work();
+    for (std::thread& th : pool) th.join();
+}
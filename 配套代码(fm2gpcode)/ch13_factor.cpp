@@ -0,0 +1,78 @@
+// -------------------------------------------------------------------
+// ch13_factor.cpp -- For testing ch13_factor.h.
+// -------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch03_segmented.h"
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_prime_u64.h"
+#include "ch13_linear_sieve.h"
+#include "ch13_factor.h"
+
+void print_factorization(std::uint64_t n) {
+  std::cout << n << " =";
+  bool first = true;
+  for (auto pk : factor(n)) {
+    std::cout << (first ? " " : " * ") << pk.first;
+    if (pk.second > 1) std::cout << "^" << pk.second;
+    first = false;
+  }
+  std::cout << std::endl;
+}
+
+int main() {
+  typedef std::uint64_t U;
+
+  // 与线性筛的查表分解对照
+  U limit = 1000000;
+  arithmetic_tables<U> tables(limit);
+  bool same = true;
+  for (U n = 1; n <= limit; ++n) {
+    if (factor(n) != tables.factor(n)) same = false;
+  }
+  std::cout << "factor agrees with arithmetic_tables::factor up to 10^6: "
+            << same << std::endl;
+
+  // 大数：乘回去等于原数，每个因子都是素数
+  same = true;
+  for (U n = 1000000000000000000ull; n < 1000000000000010000ull; ++n) {
+    U product = 1;
+    for (auto pk : factor(n)) {
+      if (!is_prime_u64(pk.first)) same = false;
+      for (int k = 0; k < pk.second; ++k) product *= pk.first;
+    }
+    if (product != n) same = false;
+  }
+  std::cout << "factorizations of [10^18, 10^18 + 10^4) check out: " << same
+            << std::endl;
+
+  print_factorization(600851475143ull);
+  print_factorization(18446744073709551615ull);    // 2^64 - 1
+  print_factorization(3825123056546413051ull);     // 强伪素数
+  print_factorization(4611686014132420609ull);     // (2^31 - 1)^2
+  print_factorization(2147483647ull * 2147483629ull * 3);
+
+  // 62 位的半素数：两个 31 位素数之积
+  std::vector<U> semiprimes = {
+    2147483647ull * 2147483629ull,
+    2147483587ull * 2147483563ull,
+    1073741827ull * 4294967291ull,
+    3037000493ull * 1518500213ull,
+  };
+  for (U n : semiprimes) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto f = factor(n);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+    std::cout << n << " = " << f[0].first << " * " << f[1].first << " ("
+              << duration.count() << " ms)" << std::endl;
+  }
+}
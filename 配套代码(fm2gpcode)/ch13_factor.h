@@ -0,0 +1,128 @@
+// -------------------------------------------------------------------
+// ch13_factor.h -- Integer factorization with Pollard-Brent rho
+// (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// factor(n) 分三步：
+//   1. 用 sieving_primes 筛出的小素数试除；
+//   2. 剩下的部分用 is_prime_u64 判定，素数直接收下；
+//   3. 合数用 Pollard rho 拆成两个因子，分别重复第 2、3 步。
+//
+// rho 迭代 x -> x^2 + c 模 n，用 Brent 的办法检测环：y 每走 r 步，x 跳到
+// y 的位置，r 翻倍。每一步都要求 gcd(|x - y|, n)，代价太高；这里把
+// pollard_block 步的 |x - y| 连乘起来，每块只求一次 gcd。若某块的乘积
+// 恰好含有 n 的全部因子（gcd = n），就从块首开始逐步重算。
+// 迭代全部在 Montgomery 形式下进行：|xR - yR| = |x - y| R，而 R 与 n
+// 互素，所以 gcd 不受影响，内层循环里没有除法。
+//
+// 使用前需先包含 ch03.h、ch03_segmented.h、ch07.h、ch12.h、ch13.h、
+// ch13_montgomery.h 和 ch13_prime_u64.h。
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define Integer typename
+#define ModularMultiplication typename
+
+// 试除到 trial_division_limit 为止；此后不超过其平方的余数必为素数
+const std::uint64_t trial_division_limit = 1 << 12;
+
+// 每 pollard_block 步求一次 gcd
+const int pollard_block = 128;
+
+template <Integer I, ModularMultiplication Op>
+I pollard_brent(const I& n, const I& c, Op op) {
+    // precondition: n is odd && n is composite && op multiplies modulo n
+    //               && c < n
+    // 返回 n 的一个因子 d（1 < d <= n）；d == n 表示这个 c 失败
+    auto f = [&](const I& x) {
+        I y = op(x, x);
+        return y >= n - c ? y - (n - c) : y + c;
+    };
+    auto distance = [](const I& x, const I& y) { return x > y ? x - y : y - x; };
+    I x, y = c, ys;
+    I q = identity_element(op);
+    I g(1);
+    for (I r(1); g == I(1); r += r) {
+        x = y;
+        for (I i(0); i < r; ++i) y = f(y);
+        for (I k(0); k < r && g == I(1); k += I(pollard_block)) {
+            // invariant: g = gcd(q, n) == 1
+            ys = y;
+            I m = std::min(I(pollard_block), r - k);
+            for (I i(0); i < m; ++i) {
+                y = f(y);
+                q = op(q, distance(x, y));
+            }
+            g = gcd(q, n);
+        }
+    }
+    if (g == n) {
+        // 整块的乘积是 n 的倍数：从块首逐步重算，找到第一个非平凡的 gcd
+        do {
+            ys = f(ys);
+            g = gcd(distance(x, ys), n);
+        } while (g == I(1));
+    }
+    return g;
+}
+
+inline const std::vector<std::uint64_t>& trial_division_primes() {
+    // 不超过 trial_division_limit 的奇素数；用有符号类型筛，ch03.h 的
+    // mark_sieve 把迭代器之差与 factor 比较
+    static const std::vector<std::uint64_t> primes = [] {
+        std::vector<std::int64_t> sieved = sieving_primes(
+            std::int64_t(trial_division_limit * trial_division_limit));
+        return std::vector<std::uint64_t>(sieved.begin(), sieved.end());
+    }();
+    return primes;
+}
+
+// 素因子分解，按素数递增给出 (p, 重数)
+inline std::vector<std::pair<std::uint64_t, int>> factor(std::uint64_t n) {
+    // precondition: n > 0
+    typedef std::uint64_t U;
+    std::vector<std::pair<U, int>> result;
+    if (n % 2 == 0) {
+        int k = std::countr_zero(n);
+        result.push_back({2, k});
+        n >>= k;
+    }
+    for (U p : trial_division_primes()) {
+        if (p * p > n) break;
+        if (n % p != 0) continue;
+        int k = 0;
+        do {
+            n /= p;
+            ++k;
+        } while (n % p == 0);
+        result.push_back({p, k});
+    }
+    if (n == 1) return result;
+
+    // 剩下的素因子都大于 trial_division_limit
+    std::vector<U> primes;
+    std::vector<U> pending = {n};
+    while (!pending.empty()) {
+        U m = pending.back();
+        pending.pop_back();
+        if (m < trial_division_limit * trial_division_limit
+            || is_prime_u64(m)) {
+            primes.push_back(m);
+            continue;
+        }
+        montgomery_multiply<U> op = m;
+        U d = m;
+        for (U c = 1; d == m; ++c) d = pollard_brent(m, to_residue(op, c), op);
+        pending.push_back(d);
+        pending.push_back(m / d);
+    }
+    std::sort(primes.begin(), primes.end());
+    for (U p : primes) {
+        if (result.empty() || result.back().first != p) result.push_back({p, 0});
+        ++result.back().second;
+    }
+    return result;
+}
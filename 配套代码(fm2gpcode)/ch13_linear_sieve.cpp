@@ -0,0 +1,48 @@
+// -------------------------------------------------------------------
+// ch13_linear_sieve.cpp -- For testing ch13_linear_sieve.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "ch03.h"
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_linear_sieve.h"
+
+int main() {
+  typedef std::uint32_t N;
+  N n = 500000;  // 覆盖 10^6 以内
+  arithmetic_tables<N> t(n);
+
+  // 与 sift 同时建表，结果一致
+  std::vector<char> v(n), w(n);
+  sift(v.begin(), n);
+  t.copy_sieve(w.begin());
+  std::cout << "copy_sieve agrees with sift: " << (v == w) << std::endl;
+
+  bool same = true;
+  for (N m = 1; m <= 100000; ++m) {
+    if (t.smallest_divisor(m) != smallest_divisor(m)) same = false;
+  }
+  std::cout << "smallest_divisor agrees with ch13.h up to 10^5: " << same
+            << std::endl;
+
+  std::cout << "euler_phi(36) = " << t.euler_phi(36)
+            << ", euler_phi(97) = " << t.euler_phi(97)
+            << ", euler_phi(1000000) = " << t.euler_phi(1000000) << std::endl;
+  std::cout << "moebius(30) = " << t.moebius(30)
+            << ", moebius(12) = " << t.moebius(12)
+            << ", moebius(1) = " << t.moebius(1) << std::endl;
+
+  std::cout << "factor(720720) =";
+  for (auto f : t.factor(720720)) std::cout << " " << f.first << "^" << f.second;
+  std::cout << std::endl;
+
+  std::cout << "Carmichael numbers below 10^6:";
+  for (N m = 3; m < 1000000; m += 2) {
+    if (t.is_carmichael(m)) std::cout << " " << m;
+  }
+  std::cout << std::endl;
+}
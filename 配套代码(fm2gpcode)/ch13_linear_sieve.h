@@ -0,0 +1,134 @@
+// -------------------------------------------------------------------
+// ch13_linear_sieve.h -- Linear (Euler) sieve for smallest prime
+// factors, Euler phi and Moebius mu (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 线性筛让每个合数只被它的最小素因子划掉一次，一遍就能填好最小素因子、
+// 欧拉函数和莫比乌斯函数表。表的下标约定与 sift 相同：下标 i 对应奇数
+// 2i + 3。偶数不必存：m = 2^k * r（r 为奇数）时，
+//     smallest_divisor(m) = 2,
+//     phi(m) = 2^(k-1) * phi(r),
+//     mu(m) = k == 1 ? -mu(r) : 0.
+// 建好表之后，smallest_divisor 是 O(1) 的查表，分解和 Korselt 判定是
+// O(log n) 的。
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#define Integer typename
+#define RandomAccessIterator typename
+
+template <Integer N>
+class arithmetic_tables {
+    std::vector<N> spf;
+    std::vector<N> phi;
+    std::vector<signed char> mu;
+    std::vector<N> odd_primes;
+    N n;
+
+    static N index(N m) { return (m - N(3)) / N(2); }
+    static N number(N i) { return i + i + N(3); }
+
+public:
+    explicit arithmetic_tables(N n) : spf(n), phi(n), mu(n), n(n) {
+        // 覆盖 3 到 2n + 1 的奇数
+        N last = limit();
+        for (N i(0); i < n; ++i) {
+            N m = number(i);
+            if (spf[i] == N(0)) {
+                spf[i] = m;
+                phi[i] = m - N(1);
+                mu[i] = -1;
+                odd_primes.push_back(m);
+            }
+            for (N p : odd_primes) {
+                // invariant: p <= spf(m)
+                if (p > spf[i] || m > last / p) break;
+                N j = index(p * m);
+                spf[j] = p;
+                if (p == spf[i]) {
+                    phi[j] = phi[i] * p;
+                    mu[j] = 0;
+                    break;
+                }
+                phi[j] = phi[i] * (p - N(1));
+                mu[j] = -mu[i];
+            }
+        }
+    }
+
+    // 表能回答的最大的数
+    N limit() const { return n == N(0) ? N(2) : number(n - N(1)); }
+
+    const std::vector<N>& primes() const { return odd_primes; }
+
+    // 以 sift 的格式写出素数标记：*(first + i) 表示 2i + 3 是否为素数
+    template <RandomAccessIterator I>
+    void copy_sieve(I first) const {
+        for (N i(0); i < n; ++i, ++first) *first = spf[i] == number(i);
+    }
+
+    N smallest_divisor(N m) const {
+        // precondition: 0 < m <= limit()
+        if (m % N(2) == N(0)) return N(2);
+        if (m == N(1)) return N(1);
+        return spf[index(m)];
+    }
+
+    bool is_prime(N m) const {
+        return m > N(1) && smallest_divisor(m) == m;
+    }
+
+    N euler_phi(N m) const {
+        // precondition: 0 < m <= limit()
+        N power_of_two(1);
+        while (m % N(2) == N(0)) {
+            m /= N(2);
+            power_of_two *= N(2);
+        }
+        N r = m == N(1) ? N(1) : phi[index(m)];
+        return power_of_two == N(1) ? r : r * (power_of_two / N(2));
+    }
+
+    int moebius(N m) const {
+        // precondition: 0 < m <= limit()
+        int sign = 1;
+        if (m % N(2) == N(0)) {
+            m /= N(2);
+            if (m % N(2) == N(0)) return 0;
+            sign = -1;
+        }
+        return m == N(1) ? sign : sign * mu[index(m)];
+    }
+
+    // 素因子分解，按素数递增给出 (p, 重数)
+    std::vector<std::pair<N, int>> factor(N m) const {
+        // precondition: 0 < m <= limit()
+        std::vector<std::pair<N, int>> result;
+        while (m != N(1)) {
+            N p = smallest_divisor(m);
+            int k = 0;
+            while (m % p == N(0)) {
+                m /= p;
+                ++k;
+            }
+            result.push_back({p, k});
+        }
+        return result;
+    }
+
+    // Korselt 判据：m 是卡迈克尔数，当且仅当 m 是无平方因子的合数，
+    // 并且对 m 的每个素因子 p 都有 (p - 1) | (m - 1)
+    bool is_carmichael(N m) const {
+        // precondition: 0 < m <= limit()
+        if (m % N(2) == N(0) || m < N(3) || is_prime(m)) return false;
+        if (mu[index(m)] == 0) return false;
+        N r = m;
+        while (r != N(1)) {
+            N p = spf[index(r)];
+            if ((m - N(1)) % (p - N(1)) != N(0)) return false;
+            r /= p;
+        }
+        return true;
+    }
+};
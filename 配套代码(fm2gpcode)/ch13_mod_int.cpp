@@ -0,0 +1,100 @@
+// -------------------------------------------------------------------
+// ch13_mod_int.cpp -- For testing ch13_mod_int.h.
+// -------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ch07.h"
+#include "ch08.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_mod_int.h"
+
+volatile std::uint64_t bench_sink;  // 防止被测的循环被优化掉
+
+template <typename F>
+double time_ns(int count, F f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  std::uint64_t sink = 0;
+  for (int i = 0; i < count; ++i) sink += f(i);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> duration = end - start;
+  bench_sink = sink;
+  return duration.count() / count;
+}
+
+int main() {
+  typedef std::uint64_t U;
+  typedef mod_int<1000000007> Z;
+  std::mt19937_64 random(2015);
+
+  // mod_int 直接用于 ch07 的 power_monoid 和 power_group
+  U n = 1000000000000000000ull;
+  std::cout << "power_monoid(Z(3), 10^18) = " << power_monoid(Z(3), n)
+            << ", modulo_multiply: "
+            << power_semigroup(U(3), n, modulo_multiply<U>(1000000007))
+            << std::endl;
+  std::cout << "power_monoid(Z(3), 0, multiplies) = "
+            << power_monoid(Z(3), 0, std::multiplies<Z>()) << std::endl;
+  std::cout << "power_group(Z(2), -1) * 2 = " << power_group(Z(2), -1) * Z(2)
+            << std::endl;
+  std::cout << "Z(-1) = " << Z(-1) << ", Z(1) / Z(3) * Z(3) = "
+            << Z(1) / Z(3) * Z(3) << std::endl;
+
+  // ch08 的 polynomial_value：x^3 - 2x + 5 在 x = 10^9 处
+  int poly[] = {1, 0, -2, 5};
+  std::cout << "polynomial_value({1, 0, -2, 5}, Z(10^9)) = "
+            << polynomial_value(poly, poly + 4, Z(1000000000)) << std::endl;
+
+  // barrett_multiply 与 modulo_multiply 对照
+  bool same = true;
+  for (int i = 0; i < 1000000; ++i) {
+    U m = (random() >> 32) | 2;
+    barrett_multiply<U> barrett(m);
+    U a = random() % m, b = random() % m;
+    if (barrett(a, b) != modulo_multiply<U>(m)(a, b)) same = false;
+  }
+  std::cout << "barrett_multiply<uint64_t> agrees with modulo_multiply: "
+            << same << std::endl;
+
+  typedef unsigned __int128 U128;
+  same = true;
+  for (int i = 0; i < 1000000; ++i) {
+    U m = random() | 2;
+    barrett_multiply<U128> barrett(m);
+    U128 a = random() % m, b = random() % m;
+    if (barrett(a, b) != a * b % m) same = false;
+  }
+  std::cout << "barrett_multiply<unsigned __int128> agrees with % for "
+            << "64-bit moduli: " << same << std::endl;
+  U p = 4294967291ull;
+  std::cout << "miller_rabin_test(2^32 - 5, base 2, barrett_multiply) = "
+            << miller_rabin_test(p, (p - 1) / 2, U(1), U(2),
+                                 barrett_multiply<U>(p)) << std::endl;
+
+  // 10^6 次 power_semigroup(a, 10^9 + 5)：模数 10^9 + 7 的几种写法
+  int count = 1000000;
+  U e = 1000000005;
+  U m = 1000000007;
+  modulo_multiply<U> mod_m(m);
+  barrett_multiply<U> barrett_m(m);
+  montgomery_multiply<std::uint32_t> mont_m(m);
+  std::cout << "a^(10^9 + 5) mod 10^9 + 7:" << std::endl;
+  std::cout << "  modulo_multiply:     " << time_ns(count, [&](int i) {
+    return power_semigroup(U(i + 2), e, mod_m);
+  }) << " ns" << std::endl;
+  std::cout << "  mod_int:             " << time_ns(count, [&](int i) {
+    return power_semigroup(Z(i + 2), e).value();
+  }) << " ns" << std::endl;
+  std::cout << "  barrett_multiply:    " << time_ns(count, [&](int i) {
+    return power_semigroup(U(i + 2), e, barrett_m);
+  }) << " ns" << std::endl;
+  std::cout << "  montgomery_multiply: " << time_ns(count, [&](int i) {
+    return power_semigroup(mont_m.to(i + 2), std::uint32_t(e), mont_m);
+  }) << " ns" << std::endl;
+}
@@ -0,0 +1,149 @@
+// -------------------------------------------------------------------
+// ch13_mod_int.h -- Residues modulo a compile-time constant, and
+// Barrett reduction for moduli known only at run time
+// (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// modulo_multiply<I> 把模数存为运行时成员，x % modulus 只能用硬件除法。
+// mod_int<M> 的模数是模板参数，x % M 在编译期就能被替换成乘法和移位；
+// 它重载了算术运算符，所以可直接用于 power_monoid(a, n)、
+// polynomial_value 和 solutions/7_2.cpp 中的矩阵快速幂。乘法单位元
+// 由 ch07.h 的 identity_element(std::multiplies<T>) 给出。
+//
+// 模数只在运行时才知道时，barrett_multiply 预先算出倒数
+// r = floor((2^w - 1) / n)（w 为 I 的位数），用 multiply_wide 的高半部分
+// 估计商 q = floor(xr / 2^w)，误差很小，余数只需一两次修正。要求
+// n < 2^(w/2)，使乘积 x 不超过一个字：I = std::uint64_t 时 n < 2^32，
+// I = unsigned __int128 时 n < 2^64。
+//
+// 使用前需先包含 ch07.h、ch12.h、ch13.h 和 ch13_montgomery.h。
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+#define Integer typename
+
+template <std::uint32_t M>
+class mod_int {
+    // invariant: x < M
+    std::uint32_t x;
+
+public:
+    static constexpr std::uint32_t modulus = M;
+
+    constexpr mod_int() : x(0) {}
+
+    template <Integer T>
+    constexpr mod_int(T a) : x(0) {
+        // 负数取非负的代表元
+        if constexpr (std::is_signed_v<T>) {
+            long long r = (long long)a % (long long)M;
+            x = std::uint32_t(r < 0 ? r + M : r);
+        } else {
+            x = std::uint32_t(a % M);
+        }
+    }
+
+    constexpr std::uint32_t value() const { return x; }
+
+    constexpr mod_int& operator+=(const mod_int& y) {
+        x = x >= M - y.x ? x - (M - y.x) : x + y.x;
+        return *this;
+    }
+
+    constexpr mod_int& operator-=(const mod_int& y) {
+        x = x >= y.x ? x - y.x : x + (M - y.x);
+        return *this;
+    }
+
+    constexpr mod_int& operator*=(const mod_int& y) {
+        x = std::uint32_t(std::uint64_t(x) * y.x % M);
+        return *this;
+    }
+
+    constexpr mod_int inverse() const {
+        // 扩展欧几里得算法，只记录系数的绝对值（见 ch13_montgomery.h 的 modular_inverse）
+        // precondition: gcd(x, M) == 1
+        std::uint32_t x0 = 0, x1 = 1, r0 = M, r1 = x;
+        bool odd = false;
+        while (r1 != 0) {
+            std::uint32_t q = r0 / r1;
+            std::uint32_t r2 = r0 - q * r1;
+            std::uint32_t x2 = x0 + q * x1;
+            r0 = r1;
+            r1 = r2;
+            x0 = x1;
+            x1 = x2;
+            odd = !odd;
+        }
+        return mod_int(odd ? x0 : M - x0);
+    }
+
+    constexpr mod_int& operator/=(const mod_int& y) {
+        return *this *= y.inverse();
+    }
+
+    constexpr mod_int operator-() const { return mod_int() - *this; }
+
+    friend constexpr mod_int operator+(mod_int a, const mod_int& b) {
+        return a += b;
+    }
+    friend constexpr mod_int operator-(mod_int a, const mod_int& b) {
+        return a -= b;
+    }
+    friend constexpr mod_int operator*(mod_int a, const mod_int& b) {
+        return a *= b;
+    }
+    friend constexpr mod_int operator/(mod_int a, const mod_int& b) {
+        return a /= b;
+    }
+    friend constexpr bool operator==(const mod_int& a, const mod_int& b) {
+        return a.x == b.x;
+    }
+    friend constexpr bool operator!=(const mod_int& a, const mod_int& b) {
+        return a.x != b.x;
+    }
+    friend std::ostream& operator<<(std::ostream& os, const mod_int& a) {
+        return os << a.x;
+    }
+};
+
+template <Integer I>
+struct barrett_multiply {
+    I modulus;
+    I reciprocal;  // floor((2^w - 1) / modulus)
+
+    barrett_multiply(const I& n) : modulus(n), reciprocal(~I(0) / n) {
+        // precondition: 1 < n < 2^(w/2)
+    }
+
+    I reduce(const I& x) const {
+        // x mod modulus；商的估计值至多少 2
+        I q;
+        multiply_wide(x, reciprocal, q);
+        I r = x - q * modulus;
+        if (r >= modulus) r -= modulus;
+        if (r >= modulus) r -= modulus;
+        return r;
+    }
+
+    I operator()(const I& a, const I& b) const {
+        // precondition: a < modulus && b < modulus
+        return reduce(a * b);
+    }
+};
+
+template <Integer I>
+I identity_element(const barrett_multiply<I>&) {
+    return I(1);
+}
+
+template <Integer I>
+I to_residue(const barrett_multiply<I>& op, const I& x) {
+    return op.reduce(x);
+}
+
+template <Integer I>
+I from_residue(const barrett_multiply<I>&, const I& x) {
+    return x;
+}
@@ -0,0 +1,57 @@
+// -------------------------------------------------------------------
+// ch13_montgomery.cpp -- For testing ch13_montgomery.h.
+// -------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+
+int main() {
+  typedef std::uint32_t U32;
+  typedef std::uint64_t U64;
+
+  montgomery_multiply<U32> m32(10007);
+  std::cout << "power_monoid(7, 5003, montgomery_multiply<U32>(10007)) = "
+            << m32.from(power_monoid(m32.to(7), U32(5003), m32))
+            << ", with modulo_multiply: "
+            << power_monoid(U32(7), U32(5003), modulo_multiply<U32>(10007))
+            << std::endl;
+
+  montgomery_multiply<U64> m1(10007);
+  std::cout << "(24 * multiplicative_inverse_fermat(24, 10007, mont)) % 10007 = "
+            << (24 * multiplicative_inverse_fermat(U64(24), U64(10007), m1))
+                   % 10007 << std::endl;
+  std::cout << "fermat_test(10001, 7, mont) = "
+            << fermat_test(U64(10001), U64(7), montgomery_multiply<U64>(10001))
+            << std::endl;
+  std::cout << "fermat_test(1729, 2, mont) = "
+            << fermat_test(U64(1729), U64(2), montgomery_multiply<U64>(1729))
+            << std::endl;
+  std::cout << "miller_rabin_test(1729, 27, 6, 2, mont) = "
+            << miller_rabin_test(U64(1729), U64(27), U64(6), U64(2),
+                                 montgomery_multiply<U64>(1729))
+            << std::endl;
+  std::cout << "miller_rabin_test(10007, 5003, 1, 7, mont) = "
+            << miller_rabin_test(U64(10007), U64(5003), U64(1), U64(7),
+                                 montgomery_multiply<U64>(10007))
+            << std::endl;
+
+  // 超过 2^32 的模数：modulo_multiply<U64> 会溢出，Montgomery 不会
+  U64 p = 18446744073709551557ull;  // 小于 2^64 的最大素数
+  montgomery_multiply<U64> big(p);
+  std::cout << "fermat_test(2^64 - 59, 3, mont) = "
+            << fermat_test(p, U64(3), big) << std::endl;
+  U64 inv = multiplicative_inverse_fermat(U64(123456789), p, big);
+  std::cout << "123456789 * inverse mod (2^64 - 59) = "
+            << big.from(big(big.to(123456789), big.to(inv))) << std::endl;
+  std::cout << "miller_rabin_test(2^64 - 59, (p - 1) / 2, 1, 2, mont) = "
+            << miller_rabin_test(p, (p - 1) / 2, U64(1), U64(2), big)
+            << std::endl;
+  // 与 ch13.h 的版本对照（用 unsigned __int128 避免溢出）
+  typedef unsigned __int128 U128;
+  std::cout << "fermat_test(2^64 - 59, 3) with unsigned __int128 = "
+            << fermat_test(U128(p), U128(3)) << std::endl;
+}
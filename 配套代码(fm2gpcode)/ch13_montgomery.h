@@ -0,0 +1,201 @@
+// -------------------------------------------------------------------
+// ch13_montgomery.h -- Montgomery multiplication as a drop-in for
+// modulo_multiply (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 对奇数模 n 和 R = 2^w（w 为 I 的位数），Montgomery 形式把 x 表示为
+// xR mod n。两个 Montgomery 形式的乘积经过 REDC 约简后仍是 Montgomery
+// 形式，约简只需要乘法和移位，不需要硬件除法。乘积用两倍字长计算
+// （32 位用 64 位，64 位用 unsigned __int128），所以模数可以用满整个
+// 字长，而 modulo_multiply<std::uint64_t> 在模数超过 2^32 时就会溢出。
+// unsigned __int128 的乘积由四个 64 位部分积拼成。
+//
+// montgomery_multiply 满足 SemigroupOperation，identity_element 返回 1
+// 的 Montgomery 形式，因此可直接用于 power_semigroup 和 power_monoid。
+// 进出 Montgomery 形式用 to_residue / from_residue；它们对
+// modulo_multiply 也有定义（不做变换），下面带运算参数的 fermat_test、
+// miller_rabin_test 和 multiplicative_inverse_fermat 对两种运算都适用。
+// inverse_operation 对两种运算都返回求逆元的函数对象（用 modular_inverse），
+// 于是它们可以作为 ch07_power.h 中 power_group_naf 的 GroupOperation。
+//
+// 使用前需先包含 ch07.h、ch12.h 和 ch13.h。
+
+#include <cstdint>
+
+#define Integer typename
+#define ModularMultiplication typename
+
+// 两倍字长的乘积：返回低半部分，高半部分写入 hi
+inline std::uint32_t multiply_wide(std::uint32_t a, std::uint32_t b,
+                                   std::uint32_t& hi) {
+    std::uint64_t p = std::uint64_t(a) * b;
+    hi = std::uint32_t(p >> 32);
+    return std::uint32_t(p);
+}
+
+inline std::uint64_t multiply_wide(std::uint64_t a, std::uint64_t b,
+                                   std::uint64_t& hi) {
+    unsigned __int128 p = (unsigned __int128)a * b;
+    hi = std::uint64_t(p >> 64);
+    return std::uint64_t(p);
+}
+
+inline unsigned __int128 multiply_wide(unsigned __int128 a,
+                                       unsigned __int128 b,
+                                       unsigned __int128& hi) {
+    // 用四个 64 x 64 位的部分积拼出 256 位的乘积
+    typedef unsigned __int128 U;
+    const U mask = ~std::uint64_t(0);
+    U p00 = (a & mask) * (b & mask);
+    U p01 = (a & mask) * (b >> 64);
+    U p10 = (a >> 64) * (b & mask);
+    U p11 = (a >> 64) * (b >> 64);
+    U middle = (p00 >> 64) + (p01 & mask) + (p10 & mask);
+    hi = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+    return (p00 & mask) | (middle << 64);
+}
+
+template <Integer I>
+struct montgomery_multiply {
+    I modulus;
+    I inverse;  // modulus^(-1) mod R
+    I one;      // R mod modulus，即 1 的 Montgomery 形式
+    I r2;       // R^2 mod modulus
+
+    montgomery_multiply(const I& n) : modulus(n) {
+        // precondition: n is odd && n > 1
+        // 牛顿迭代：每次迭代使 n * inverse = 1 (mod 2^k) 的位数翻倍
+        inverse = n;  // 对奇数 n，n * n = 1 (mod 8)
+        for (int bits = 3; bits < int(sizeof(I) * 8); bits += bits) {
+            inverse *= I(2) - n * inverse;
+        }
+        one = (I(0) - n) % n;
+        // 先得到 2 的 Montgomery 形式 2R mod n（避免 one + one 溢出），
+        // 再平方 log2(w) 次得到 2^w 的 Montgomery 形式，即 R^2 mod n
+        r2 = one >= n - one ? one - (n - one) : one + one;
+        for (int i = 1; i < int(sizeof(I) * 8); i += i) r2 = (*this)(r2, r2);
+    }
+
+    I reduce(const I& hi, const I& lo) const {
+        // 返回 (hi * R + lo) / R mod n
+        // precondition: hi < modulus
+        I m = lo * inverse;
+        I mn_hi;
+        multiply_wide(m, modulus, mn_hi);
+        // hi * R + lo - m * n 的低半部分为 0
+        I t = hi - mn_hi;
+        return hi < mn_hi ? t + modulus : t;
+    }
+
+    I operator()(const I& a, const I& b) const {
+        I hi;
+        I lo = multiply_wide(a, b, hi);
+        return reduce(hi, lo);
+    }
+
+    I to(const I& x) const { return (*this)(x % modulus, r2); }
+    I from(const I& x) const { return reduce(I(0), x); }
+};
+
+template <Integer I>
+I identity_element(const montgomery_multiply<I>& op) {
+    return op.one;
+}
+
+template <Integer I>
+I to_residue(const montgomery_multiply<I>& op, const I& x) {
+    return op.to(x);
+}
+
+template <Integer I>
+I from_residue(const montgomery_multiply<I>& op, const I& x) {
+    return op.from(x);
+}
+
+template <Integer I>
+I to_residue(const modulo_multiply<I>& op, const I& x) {
+    return x % op.modulus;
+}
+
+template <Integer I>
+I from_residue(const modulo_multiply<I>&, const I& x) {
+    return x;
+}
+
+template <Integer I>
+I modular_inverse(I a, I n) {
+    // precondition: 0 <= a < n && n > 1
+    // 扩展欧几里得算法，只记录系数的绝对值：系数的符号逐步交替，
+    // 绝对值不超过 n，所以对无符号类型也不会溢出
+    // 返回 a 模 n 的逆元；不可逆时返回 0
+    I x0(0);  // invariant: r0 = (-1)^(k+1) x0 a (mod n)
+    I x1(1);  // invariant: r1 = (-1)^k x1 a (mod n)
+    I r0 = n;
+    I r1 = a;
+    bool odd = false;  // k 的奇偶
+    while (r1 != I(0)) {
+        I q = r0 / r1;
+        I r2 = r0 - q * r1;
+        I x2 = x0 + q * x1;
+        r0 = r1;
+        r1 = r2;
+        x0 = x1;
+        x1 = x2;
+        odd = !odd;
+    }
+    if (r0 != I(1)) return I(0);
+    return odd ? x0 : n - x0;
+}
+
+// 与 ch07.h 中 std::plus、std::multiplies 的 inverse_operation 对应：
+// 模 n 的乘法运算也可以作为 GroupOperation 使用（元素须与 n 互素）
+template <Integer I, ModularMultiplication Op>
+struct modular_reciprocal {
+    Op op;
+
+    I operator()(const I& x) const {
+        return to_residue(op, modular_inverse(from_residue(op, x),
+                                              op.modulus));
+    }
+};
+
+template <Integer I>
+modular_reciprocal<I, modulo_multiply<I>>
+inverse_operation(const modulo_multiply<I>& op) {
+    return {op};
+}
+
+template <Integer I>
+modular_reciprocal<I, montgomery_multiply<I>>
+inverse_operation(const montgomery_multiply<I>& op) {
+    return {op};
+}
+
+template <Integer I, ModularMultiplication Op>
+I multiplicative_inverse_fermat(I a, I p, Op op) {
+    // precondition: p is prime & a > 0 & op multiplies modulo p
+    return from_residue(op, power_monoid(to_residue(op, a), p - I(2), op));
+}
+
+template <Integer I, ModularMultiplication Op>
+bool fermat_test(I n, I witness, Op op) {
+    // precondition: 0 < witness < n & op multiplies modulo n
+    I remainder(power_semigroup(to_residue(op, witness), n - I(1), op));
+    return remainder == identity_element(op);
+}
+
+template <Integer I, ModularMultiplication Op>
+bool miller_rabin_test(I n, I q, I k, I w, Op op) {
+    // precondition n > 1 && n - 1 = 2^kq && q is odd
+    //              && op multiplies modulo n
+    I one = identity_element(op);
+    I minus_one = n - one;  // -1 的剩余类表示
+    I x = power_semigroup(to_residue(op, w), q, op);
+    if (x == one || x == minus_one) return true;
+    for (I i(1); i < k; ++i) {
+        // invariant x = w^{2^{i-1}q}
+        x = op(x, x);
+        if (x == minus_one) return true;
+        if (x == one)       return false;
+    }
+    return false;
+}
@@ -0,0 +1,46 @@
+// -------------------------------------------------------------------
+// ch13_prime_u64.cpp -- For testing ch13_prime_u64.h.
+// -------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "ch07.h"
+#include "ch12.h"
+#include "ch13.h"
+#include "ch13_montgomery.h"
+#include "ch13_prime_u64.h"
+
+int main() {
+  typedef std::uint64_t U;
+
+  bool same = true;
+  for (U n = 0; n < 1000000; ++n) {
+    if (is_prime_u64(n) != bool(is_prime(n))) same = false;
+  }
+  std::cout << "is_prime_u64 agrees with is_prime below 10^6: " << same
+            << std::endl;
+
+  // 能骗过前几个底数的强伪素数
+  std::cout << "is_prime_u64(3215031751) = " << is_prime_u64(3215031751ull)
+            << std::endl;
+  std::cout << "is_prime_u64(3825123056546413051) = "
+            << is_prime_u64(3825123056546413051ull) << std::endl;
+  std::cout << "is_prime_u64(2^61 - 1) = "
+            << is_prime_u64((U(1) << 61) - 1) << std::endl;
+  std::cout << "is_prime_u64(2^64 - 59) = "
+            << is_prime_u64(18446744073709551557ull) << std::endl;
+  std::cout << "is_prime_u64(4294967291 * 4294967279) = "
+            << is_prime_u64(4294967291ull * 4294967279ull) << std::endl;
+
+  // 18 位数：平均每个数的耗时
+  U first = 100000000000000000ull;
+  int count = 0;
+  int tests = 1000000;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < tests; ++i) count += is_prime_u64(first + i);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> duration = end - start;
+  std::cout << "primes in [10^17, 10^17 + 10^6): " << count << ", "
+            << duration.count() / tests << " ns per number" << std::endl;
+}
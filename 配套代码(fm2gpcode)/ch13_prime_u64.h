@@ -0,0 +1,51 @@
+// -------------------------------------------------------------------
+// ch13_prime_u64.h -- Deterministic Miller-Rabin test for 64-bit
+// integers (extension of Chapter 13 of fM2GP).
+// -------------------------------------------------------------------
+// 对固定的一组底数，已验证不存在小于 2^64 的合数能通过全部强伪素数
+// 测试，因此 miller_rabin_test 在这组底数上是确定性的：
+//
+//     n < 2^32：2, 7, 61
+//     n < 2^64：2, 325, 9375, 28178, 450775, 9780504, 1795265022
+//
+// is_prime_u64 先用小素数试除，再用 countr_zero 一步求出 n - 1 = 2^k q，
+// 最后用 Montgomery 乘法（不会溢出，也不做除法）运行上面的测试。
+// 使用前需先包含 ch07.h、ch12.h、ch13.h 和 ch13_montgomery.h。
+
+#include <bit>
+#include <cstdint>
+
+inline bool is_prime_u64(std::uint64_t n) {
+    static const unsigned char small_primes[] = {
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47,
+        53, 59, 61, 67, 71, 73, 79, 83, 89, 97
+    };
+    if (n < 2) return false;
+    for (std::uint64_t p : small_primes) {
+        if (n % p == 0) return n == p;
+    }
+    if (n < 101 * 101) return true;
+
+    int k = std::countr_zero(n - 1);
+    std::uint64_t q = (n - 1) >> k;
+    if (n >> 32 == 0) {
+        typedef std::uint32_t U;
+        static const U witnesses[] = {2, 7, 61};
+        montgomery_multiply<U> op = U(n);
+        for (U w : witnesses) {
+            if (!miller_rabin_test(U(n), U(q), U(k), w, op)) return false;
+        }
+        return true;
+    }
+    typedef std::uint64_t U;
+    static const U witnesses[] = {
+        2, 325, 9375, 28178, 450775, 9780504, 1795265022
+    };
+    montgomery_multiply<U> op = n;
+    for (U w : witnesses) {
+        // 底数是 n 的倍数时这一轮不提供信息
+        if (w % n == 0) continue;
+        if (!miller_rabin_test(n, q, U(k), w, op)) return false;
+    }
+    return true;
+}